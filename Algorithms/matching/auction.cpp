@@ -0,0 +1,60 @@
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "auction.h"
+#include "hungarian.h"
+
+void testAssignment() {
+    Auction auction(3, 2);
+    long costs[3][3] = {{4, 1, 3}, {2, 0, 5}, {3, 2, 2}};
+    for (int i = 0; i < 3; ++ i) {
+        for (int j = 0; j < 3; ++ j) {
+            auction.setCost(i, j, costs[i][j]);
+        }
+    }
+    assert(auction.solve() == 5);
+    assert(auction.matchOfRow(0) == 1);
+    assert(auction.matchOfRow(1) == 0);
+    assert(auction.matchOfRow(2) == 2);
+    for (int i = 0; i < 3; ++ i) {
+        assert(auction.matchOfColumn(auction.matchOfRow(i)) == i);
+    }
+}
+
+// Same totals as the Hungarian algorithm, small matrices are solved serially,
+// the big ones bid on several threads.
+template <class Cost>
+void testRandom(unsigned threads) {
+    std::mt19937 random(9);
+    for (int round = 0; round < 100; ++ round) {
+        size_t N = round < 80 ? 1 + random() % 20 : 200 + random() % 300;
+        BasicAuction<Cost> auction(N, threads);
+        BasicHungarian<Cost> hungarian(N, N);
+        int range = 1 + random() % 1000;
+        for (size_t i = 0; i < N; ++ i) {
+            for (size_t j = 0; j < N; ++ j) {
+                Cost cost = (Cost)(random() % range) - range / 4;
+                auction.setCost(i, j, cost);
+                hungarian.setCost(i, j, cost);
+            }
+        }
+
+        Cost total = auction.solve();
+        assert(total == hungarian.solve());
+        std::vector<bool> taken(N, false);
+        for (size_t i = 0; i < N; ++ i) {
+            int j = auction.matchOfRow(i);
+            assert(j >= 0 && !taken[j]);
+            taken[j] = true;
+            assert(auction.matchOfColumn(j) == (int)i);
+        }
+    }
+}
+
+int main () {
+    testAssignment();
+    testRandom<long>(1);
+    testRandom<long>(4);
+    testRandom<int>(3);
+}
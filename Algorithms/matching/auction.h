@@ -0,0 +1,261 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+
+// Min cost assignment of an N x N matrix by the Bertsekas auction with
+// epsilon scaling. Rows bid for columns: a free row takes the column j with the
+// smallest cost[i][j] + price[j] and raises its price by the gap to the second
+// smallest plus epsilon, the row holding it before becomes free. Costs are
+// multiplied by N + 1, then an assignment in which every row holds a column
+// within epsilon 1 of its best one is optimal. Each scale divides epsilon by
+// ALPHA, frees all rows and keeps the prices of the previous scale.
+// Bidding is Jacobi style on several threads: every round all free rows
+// compute their bids in parallel against the prices of the previous round,
+// the highest bid for a column is found with atomic compare-exchange and ties
+// go to the lower row. The winners are assigned on one thread between rounds.
+// Once fewer rows are free than PARALLEL_BIDDERS the rest of the scale runs on
+// that thread too, Gauss-Seidel style: a bid is assigned as soon as it is made.
+template <class Cost>
+class BasicAuction {
+    public:
+        BasicAuction(size_t N, unsigned threads = std::thread::hardware_concurrency());
+        void setCost(int row, int column, Cost cost) { m_cost[row * m_N + column] = cost; }
+        Cost * row(int row) { return &m_cost[row * m_N]; }
+
+        Cost solve();
+
+        int matchOfRow(int row) const { return m_matchRow[row]; }
+        int matchOfColumn(int column) const { return m_matchColumn[column]; }
+        size_t rounds() const { return m_rounds; }
+
+        static constexpr long ALPHA = 6;
+        static constexpr size_t PARALLEL_BIDDERS = 256;
+
+    private:
+        // runs on one thread between the steps of a round
+        struct RoundStep {
+            BasicAuction * auction;
+            void operator()() noexcept { auction->roundStep(); }
+        };
+
+        void worker(std::barrier<RoundStep> & sync);
+        void roundStep() noexcept;
+        void bidRows();
+        void claimColumns();
+        void assignWinners();
+        void bidSerially();
+        void startScale();
+
+        // best column of the row and the price which keeps it epsilon best
+        void bid(int row, int & column, long & price) const;
+        void assign(int row, int column, long price, std::vector<int> & freed);
+
+        size_t m_N;
+        unsigned m_threads;
+        std::vector<Cost> m_cost;
+        std::vector<int> m_matchRow;
+        std::vector<int> m_matchColumn;
+        std::vector<long> m_price;
+        long m_epsilon = 1;
+
+        // free rows bidding in this round and their bids
+        std::vector<int> m_bidders;
+        std::vector<int> m_bidColumn;
+        std::vector<long> m_bidPrice;
+        std::vector<int> m_next;
+
+        // highest bid for a column and the row which made it
+        std::vector<std::atomic<long>> m_high;
+        std::vector<std::atomic<int>> m_winner;
+
+        std::atomic<size_t> m_cursor = 0;
+        int m_step = 0;
+        bool m_done = false;
+        size_t m_rounds = 0;
+};
+
+template <class Cost>
+inline BasicAuction<Cost>::BasicAuction(size_t N, unsigned threads)
+: m_N(N)
+, m_threads(std::max(1u, threads))
+, m_cost(N * N, 0)
+{
+}
+
+// Returns the min total cost.
+template <class Cost>
+inline Cost BasicAuction<Cost>::solve() {
+    size_t N = m_N;
+    m_price.assign(N, 0);
+    m_matchRow.assign(N, -1);
+    m_matchColumn.assign(N, -1);
+    m_bidColumn.resize(N);
+    m_bidPrice.resize(N);
+    std::vector<std::atomic<long>>(N).swap(m_high);
+    std::vector<std::atomic<int>>(N).swap(m_winner);
+    for (size_t column = 0; column < N; ++ column) {
+        m_high[column] = std::numeric_limits<long>::min();
+        m_winner[column] = -1;
+    }
+    m_bidders.clear();
+    m_rounds = 0;
+    m_done = false;
+
+    long largest = 1;
+    for (Cost cost : m_cost) largest = std::max(largest, std::abs((long)cost));
+    m_epsilon = largest * (N + 1);
+    startScale();
+
+    if (!m_done) {
+        m_step = 0;
+        std::barrier<RoundStep> sync(m_threads, RoundStep{this});
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < m_threads; ++ i) {
+            threads.emplace_back(&BasicAuction::worker, this, std::ref(sync));
+        }
+        worker(sync);
+        for (auto & thread : threads) thread.join();
+    }
+
+    Cost total = 0;
+    for (size_t row = 0; row < N; ++ row) {
+        total += m_cost[row * N + m_matchRow[row]];
+    }
+    return total;
+}
+
+template <class Cost>
+inline void BasicAuction<Cost>::worker(std::barrier<RoundStep> & sync) {
+    while (true) {
+        bidRows();
+        sync.arrive_and_wait();
+        claimColumns();
+        sync.arrive_and_wait();
+        if (m_done) break;
+    }
+}
+
+template <class Cost>
+inline void BasicAuction<Cost>::roundStep() noexcept {
+    m_cursor = 0;
+    if (++ m_step % 2 != 0) return;
+
+    ++ m_rounds;
+    assignWinners();
+    while (!m_done && m_bidders.size() < PARALLEL_BIDDERS) {
+        bidSerially();
+        startScale();
+    }
+}
+
+// Next scale when no row is free, all rows bid again.
+template <class Cost>
+inline void BasicAuction<Cost>::startScale() {
+    if (!m_bidders.empty()) return;
+    if (m_epsilon == 1) {
+        m_done = true;
+        return;
+    }
+    m_epsilon = std::max(1L, m_epsilon / ALPHA);
+    std::fill(m_matchRow.begin(), m_matchRow.end(), -1);
+    std::fill(m_matchColumn.begin(), m_matchColumn.end(), -1);
+    for (size_t row = 0; row < m_N; ++ row) m_bidders.push_back(row);
+}
+
+template <class Cost>
+inline void BasicAuction<Cost>::bid(int row, int & column, long & price) const {
+    const Cost * cost = &m_cost[row * m_N];
+    const long scale = m_N + 1;
+    const long * prices = m_price.data();
+    long best = std::numeric_limits<long>::max(), second = best;
+    int bestColumn = 0;
+    for (size_t j = 0; j < m_N; ++ j) {
+        long value = cost[j] * scale + prices[j];
+        if (value < best) {
+            second = best;
+            best = value;
+            bestColumn = j;
+        } else if (value < second) {
+            second = value;
+        }
+    }
+    column = bestColumn;
+    price = m_N == 1 ? prices[bestColumn] + m_epsilon : prices[bestColumn] + second - best + m_epsilon;
+}
+
+// The price of the column is only raised, a bid is its new price.
+template <class Cost>
+inline void BasicAuction<Cost>::bidRows() {
+    for (size_t i; (i = m_cursor ++) < m_bidders.size(); ) {
+        int column;
+        long price;
+        bid(m_bidders[i], column, price);
+        m_bidColumn[i] = column;
+        m_bidPrice[i] = price;
+        long high = m_high[column].load(std::memory_order_relaxed);
+        while (high < price && !m_high[column].compare_exchange_weak(high, price, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+template <class Cost>
+inline void BasicAuction<Cost>::claimColumns() {
+    for (size_t i; (i = m_cursor ++) < m_bidders.size(); ) {
+        int column = m_bidColumn[i];
+        if (m_bidPrice[i] != m_high[column].load(std::memory_order_relaxed)) continue;
+        int row = m_bidders[i];
+        int winner = m_winner[column].load(std::memory_order_relaxed);
+        while ((winner == -1 || row < winner) && !m_winner[column].compare_exchange_weak(winner, row, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+template <class Cost>
+inline void BasicAuction<Cost>::assignWinners() {
+    m_next.clear();
+    for (size_t i = 0; i < m_bidders.size(); ++ i) {
+        int row = m_bidders[i], column = m_bidColumn[i];
+        if (m_winner[column] == row) assign(row, column, m_bidPrice[i], m_next);
+        else m_next.push_back(row);
+    }
+    for (size_t i = 0; i < m_bidders.size(); ++ i) {
+        int column = m_bidColumn[i];
+        m_high[column] = std::numeric_limits<long>::min();
+        m_winner[column] = -1;
+    }
+    std::swap(m_bidders, m_next);
+}
+
+// Bids of the free rows one at a time until no row is free.
+template <class Cost>
+inline void BasicAuction<Cost>::bidSerially() {
+    while (!m_bidders.empty()) {
+        int row = m_bidders.back();
+        m_bidders.pop_back();
+        int column;
+        long price;
+        bid(row, column, price);
+        assign(row, column, price, m_bidders);
+    }
+}
+
+// The row holding the column before becomes free.
+template <class Cost>
+inline void BasicAuction<Cost>::assign(int row, int column, long price, std::vector<int> & freed) {
+    int previous = m_matchColumn[column];
+    if (previous != -1) {
+        m_matchRow[previous] = -1;
+        freed.push_back(previous);
+    }
+    m_matchColumn[column] = row;
+    m_matchRow[row] = column;
+    m_price[column] = price;
+}
+
+using Auction = BasicAuction<long>;
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include "hopcroft-karp.h"
+#include "manhattan-grid.h"
+#include "../max-flow/dinitz-basic.h"
+#include "../max-flow/dinitz.h"
+
+// Compares Hopcroft-Karp with the max flow networks on Taxi instances.
+// Usage: ./a.out [people cars]
+// People and cars are spread over a square, a car can pick up a person within
+// the Manhattan distance reach, which is chosen for about `degree` cars per person.
+
+struct Coord {
+    int x;
+    int y;
+};
+
+struct Instance {
+    std::vector<Coord> people, cars;
+    long reach;
+};
+
+Instance random(int peopleCnt, int carsCnt, int degree, unsigned seed) {
+    std::mt19937 random(seed);
+    const int side = 100000;
+    std::uniform_int_distribution<int> coordinate(0, side);
+    Instance instance{std::vector<Coord>(peopleCnt), std::vector<Coord>(carsCnt), 0};
+    for (auto & p : instance.people) p = {coordinate(random), coordinate(random)};
+    for (auto & c : instance.cars) c = {coordinate(random), coordinate(random)};
+    // the diamond of radius r covers 2 r^2 of side^2
+    instance.reach = side * std::sqrt(degree / (2.0 * carsCnt));
+    return instance;
+}
+
+inline long distance(const Coord & a, const Coord & b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+template <class Network>
+long solveFlow(const Instance & instance, size_t & edges) {
+    int peopleCnt = instance.people.size(), carsCnt = instance.cars.size();
+    const int source = 0;
+    const int sink = 1 + peopleCnt + carsCnt;
+    Network network(peopleCnt + carsCnt + 2);
+    edges = 0;
+    for (int j = 0; j < carsCnt; ++ j, ++ edges) {
+        network.addEdge(1 + peopleCnt + j, sink, 1);
+    }
+    for (int i = 0; i < peopleCnt; ++ i, ++ edges) {
+        network.addEdge(source, 1 + i, 1);
+    }
+    manhattanPairs(instance.people, instance.cars, instance.reach, [&](int i, int j) {
+        network.addEdge(1 + i, 1 + peopleCnt + j, 1);
+        ++ edges;
+    });
+    return network.maxFlow(source, sink);
+}
+
+long solveMatching(const Instance & instance, size_t & edges) {
+    int peopleCnt = instance.people.size(), carsCnt = instance.cars.size();
+    HopcroftKarp matching(peopleCnt, carsCnt);
+    edges = 0;
+    manhattanPairs(instance.people, instance.cars, instance.reach, [&](int i, int j) {
+        matching.addEdge(i, j);
+        ++ edges;
+    });
+    return matching.maxMatching();
+}
+
+// Only the pairs in reach, by trying them all or by the grid.
+long allPairs(const Instance & instance, size_t & edges) {
+    edges = 0;
+    for (const auto & person : instance.people) {
+        for (const auto & car : instance.cars) {
+            edges += distance(person, car) <= instance.reach;
+        }
+    }
+    return edges;
+}
+
+long gridPairs(const Instance & instance, size_t & edges) {
+    edges = 0;
+    manhattanPairs(instance.people, instance.cars, instance.reach, [&](int, int) { ++ edges; });
+    return edges;
+}
+
+// Edge record, two arcs of target, residue and reverse and the position.
+template <class Cap>
+constexpr double csrBytes = sizeof(typename BasicResidualGraph<Cap>::Edge) + 2 * (2 * sizeof(int) + sizeof(Cap)) + sizeof(int);
+// Edge and reverse record, both in the adjacency and the level graph lists.
+constexpr double listBytes = 2 * sizeof(DinitzBasic::Edge) + 4 * sizeof(int);
+
+// Memory of the edges is estimated from the bytes per edge, the time includes
+// generating the edges by the grid.
+template <class Solve>
+void run(const std::string & name, const Instance & instance, Solve solve, double bytes) {
+    size_t edges;
+    auto begin = std::chrono::steady_clock::now();
+    long matched = solve(instance, edges);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << name
+              << std::setw(10) << matched
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count();
+    if (bytes > 0) {
+        std::cout << std::setw(12) << std::setprecision(1) << bytes * edges / (1 << 20);
+    }
+    std::cout << "\n";
+}
+
+void compare(int peopleCnt, int carsCnt, int degree) {
+    Instance instance = random(peopleCnt, carsCnt, degree, 1);
+    double pairs = double(peopleCnt) * carsCnt;
+    std::cout << peopleCnt << " people, " << carsCnt << " cars, ~" << degree << " cars in reach\n";
+    std::cout << std::setw(14) << "edges" << std::setw(10) << "count" << std::setw(12) << "total ms" << "\n";
+    if (pairs <= 1e9) {
+        run("all pairs", instance, allPairs, 0);
+    }
+    run("grid", instance, gridPairs, 0);
+    std::cout << std::setw(14) << "algorithm" << std::setw(10) << "matched" << std::setw(12) << "total ms"
+              << std::setw(12) << "edges MB" << "\n";
+    if (pairs <= 1e8) {
+        run("dinitz basic", instance, solveFlow<DinitzBasic>, listBytes);
+    }
+    run("dinitz csr", instance, solveFlow<Dinitz>, csrBytes<long>);
+    run("dinitz csr i32", instance, solveFlow<BasicDinitz<int32_t>>, csrBytes<int32_t>);
+    // the bitset has a bit for every pair
+    size_t edges;
+    solveMatching(instance, edges);
+    run("hopcroft-karp", instance, solveMatching, pairs / 8 / std::max<size_t>(1, edges));
+    std::cout << "\n";
+}
+
+int main (int argc, char * argv[]) {
+    if (argc == 3) {
+        compare(std::atoi(argv[1]), std::atoi(argv[2]), 20);
+        return 0;
+    }
+    compare(2000, 2000, 20);
+    compare(10000, 10000, 20);
+    compare(10000, 10000, 500);
+    compare(30000, 30000, 50);
+    compare(100000, 100000, 10);
+}
@@ -0,0 +1,79 @@
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "hopcroft-karp.h"
+
+void testMatching() {
+    HopcroftKarp matching(4, 4);
+    matching.addEdge(0, 0);
+    matching.addEdge(0, 1);
+    matching.addEdge(1, 0);
+    matching.addEdge(2, 1);
+    matching.addEdge(2, 2);
+    matching.addEdge(3, 2);
+    assert(matching.maxMatching() == 3);
+
+    for (int a = 0; a < 4; ++ a) {
+        int b = matching.matchOfLeft(a);
+        if (b != -1) assert(matching.matchOfRight(b) == a);
+    }
+}
+
+// no cars or no people, the rows have no words
+void testEmptySide() {
+    HopcroftKarp noRight(3, 0);
+    assert(noRight.maxMatching() == 0);
+    assert(noRight.matchOfLeft(2) == -1);
+    HopcroftKarp noLeft(0, 5);
+    assert(noLeft.maxMatching() == 0);
+}
+
+// Simple augmenting paths one at a time, to compare with.
+int kuhn(const std::vector<std::vector<int>> & adjacent, int right) {
+    std::vector<int> match(right, -1);
+    std::vector<bool> seen;
+    auto augment = [&](auto & self, int a) -> bool {
+        for (int b : adjacent[a]) {
+            if (seen[b]) continue;
+            seen[b] = true;
+            if (match[b] == -1 || self(self, match[b])) {
+                match[b] = a;
+                return true;
+            }
+        }
+        return false;
+    };
+    int matched = 0;
+    for (size_t a = 0; a < adjacent.size(); ++ a) {
+        seen.assign(right, false);
+        matched += augment(augment, a);
+    }
+    return matched;
+}
+
+void testRandom() {
+    std::mt19937 random(3);
+    for (int round = 0; round < 300; ++ round) {
+        int left = 1 + random() % 150, right = 1 + random() % 150;
+        double density = (random() % 100) / 1000.0;
+        std::bernoulli_distribution edge(density);
+        HopcroftKarp matching(left, right);
+        std::vector<std::vector<int>> adjacent(left);
+        for (int a = 0; a < left; ++ a) {
+            for (int b = 0; b < right; ++ b) {
+                if (edge(random)) {
+                    matching.addEdge(a, b);
+                    adjacent[a].push_back(b);
+                }
+            }
+        }
+        assert(matching.maxMatching() == kuhn(adjacent, right));
+    }
+}
+
+int main () {
+    testMatching();
+    testEmptySide();
+    testRandom();
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "hungarian.h"
+
+void testAssignment() {
+    Hungarian hungarian(3, 3);
+    long costs[3][3] = {{4, 1, 3}, {2, 0, 5}, {3, 2, 2}};
+    for (int i = 0; i < 3; ++ i) {
+        for (int j = 0; j < 3; ++ j) {
+            hungarian.setCost(i, j, costs[i][j]);
+        }
+    }
+    assert(hungarian.solve() == 5);
+    assert(hungarian.matchOfRow(0) == 1);
+    assert(hungarian.matchOfRow(1) == 0);
+    assert(hungarian.matchOfRow(2) == 2);
+    for (int i = 0; i < 3; ++ i) {
+        assert(hungarian.matchOfColumn(hungarian.matchOfRow(i)) == i);
+    }
+}
+
+// All assignments of rows to columns, to compare with.
+long bruteForce(const std::vector<std::vector<long>> & costs, size_t columns) {
+    std::vector<int> order(columns);
+    std::iota(order.begin(), order.end(), 0);
+    long best = -1;
+    do {
+        long total = 0;
+        for (size_t i = 0; i < costs.size(); ++ i) total += costs[i][order[i]];
+        if (best == -1 || total < best) best = total;
+    } while (std::next_permutation(order.begin(), order.end()));
+    return best;
+}
+
+// Square and wide matrices, costs may be negative.
+template <class Cost>
+void testRandom() {
+    std::mt19937 random(3);
+    for (int round = 0; round < 300; ++ round) {
+        size_t rows = 1 + random() % 6, columns = rows + random() % 3;
+        BasicHungarian<Cost> hungarian(rows, columns);
+        std::vector<std::vector<long>> costs(rows, std::vector<long>(columns));
+        for (size_t i = 0; i < rows; ++ i) {
+            for (size_t j = 0; j < columns; ++ j) {
+                costs[i][j] = (long)(random() % 100) - 30;
+                hungarian.setCost(i, j, costs[i][j]);
+            }
+        }
+
+        long total = hungarian.solve();
+        assert(total == bruteForce(costs, columns));
+        long check = 0;
+        std::vector<bool> taken(columns, false);
+        for (size_t i = 0; i < rows; ++ i) {
+            int j = hungarian.matchOfRow(i);
+            assert(j >= 0 && !taken[j]);
+            taken[j] = true;
+            check += costs[i][j];
+        }
+        assert(check == total);
+    }
+}
+
+int main () {
+    testAssignment();
+    testRandom<long>();
+    testRandom<int>();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+// Min cost assignment of every row to a distinct column by the Hungarian
+// algorithm (Kuhn-Munkres) with potentials, O(rows^2 columns). For a dense
+// cost matrix this beats any flow network: the matrix is one contiguous row
+// major array, no edge records, and each step is a linear scan of one row.
+// Rows are added one by one, each by a Dijkstra-like search over the columns:
+// the search grows a tree of alternating paths, keeping the smallest reduced
+// cost cost[i][j] - u[i] - v[j] to every column outside it, and adds the
+// column with the smallest one until it reaches a free column. The scans
+// over the columns are branch free so that they vectorize.
+template <class Cost>
+class BasicHungarian {
+    public:
+        BasicHungarian(size_t rows, size_t columns);
+        void setCost(int row, int column, Cost cost) { m_cost[row * m_columns + column] = cost; }
+        Cost * row(int row) { return &m_cost[row * m_columns]; }
+
+        Cost solve();
+
+        int matchOfRow(int row) const { return m_matchRow[row]; }
+        int matchOfColumn(int column) const { return m_matchColumn[column]; }
+
+    private:
+        void addRow(int row);
+
+        size_t m_rows, m_columns;
+        std::vector<Cost> m_cost;
+        std::vector<int> m_matchRow;
+        std::vector<int> m_matchColumn; // one more for the row being added
+
+        // potentials, reduced costs cost[i][j] - u[i] - v[j] stay >= 0
+        std::vector<Cost> m_u, m_v;
+        // search buffers
+        std::vector<Cost> m_slack; // smallest reduced cost from the tree to the column
+        std::vector<int> m_way; // previous column on the path to the column
+        std::vector<uint8_t> m_used; // column is in the tree
+        std::vector<int> m_tree; // columns in the tree
+};
+
+template <class Cost>
+inline BasicHungarian<Cost>::BasicHungarian(size_t rows, size_t columns)
+: m_rows(rows)
+, m_columns(columns)
+, m_cost(rows * columns, 0)
+{
+    if (rows > columns) {
+        throw std::invalid_argument("more rows than columns, transpose the matrix.");
+    }
+}
+
+// Returns the min total cost, every row gets a column.
+template <class Cost>
+inline Cost BasicHungarian<Cost>::solve() {
+    size_t R = m_rows, C = m_columns;
+    m_matchRow.assign(R, -1);
+    m_matchColumn.assign(C + 1, -1);
+    m_u.assign(R, 0);
+    m_v.assign(C + 1, 0);
+    m_slack.resize(C + 1);
+    m_way.resize(C + 1);
+    m_used.resize(C + 1);
+
+    for (size_t row = 0; row < R; ++ row) {
+        addRow(row);
+    }
+
+    Cost total = 0;
+    for (size_t column = 0; column < C; ++ column) {
+        int row = m_matchColumn[column];
+        if (row == -1) continue;
+        m_matchRow[row] = column;
+        total += m_cost[row * C + column];
+    }
+    return total;
+}
+
+// The extra column C is matched to the new row, the search starts from it.
+template <class Cost>
+inline void BasicHungarian<Cost>::addRow(int newRow) {
+    const size_t C = m_columns;
+    const Cost INF = std::numeric_limits<Cost>::max() / 2;
+    Cost * slack = m_slack.data();
+    Cost * v = m_v.data();
+    int * way = m_way.data();
+    uint8_t * used = m_used.data();
+
+    std::fill(m_slack.begin(), m_slack.end(), INF);
+    std::fill(m_used.begin(), m_used.end(), 0);
+    m_tree.clear();
+    m_matchColumn[C] = newRow;
+    int column = C;
+    do {
+        used[column] = 1;
+        m_tree.push_back(column);
+        int current = m_matchColumn[column];
+        const Cost * cost = &m_cost[current * C];
+        Cost u = m_u[current];
+
+        for (size_t j = 0; j < C; ++ j) {
+            Cost reduced = cost[j] - u - v[j];
+            bool better = !used[j] & (reduced < slack[j]);
+            slack[j] = better ? reduced : slack[j];
+            way[j] = better ? column : way[j];
+        }
+
+        Cost delta = INF;
+        for (size_t j = 0; j < C; ++ j) {
+            delta = std::min(delta, used[j] ? INF : slack[j]);
+        }
+        int next = 0;
+        while (used[next] || slack[next] != delta) ++ next;
+
+        // the tree gets closer to the columns outside by delta
+        for (int j : m_tree) {
+            m_u[m_matchColumn[j]] += delta;
+            v[j] -= delta;
+        }
+        for (size_t j = 0; j < C; ++ j) {
+            slack[j] -= used[j] ? 0 : delta;
+        }
+        column = next;
+    } while (m_matchColumn[column] != -1);
+
+    // augment along the alternating path back to the extra column
+    while (column != (int)C) {
+        int previous = way[column];
+        m_matchColumn[column] = m_matchColumn[previous];
+        column = previous;
+    }
+}
+
+using Hungarian = BasicHungarian<long>;
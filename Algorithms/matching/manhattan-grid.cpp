@@ -0,0 +1,43 @@
+#include <cassert>
+#include <random>
+#include <vector>
+#include <set>
+
+#include "manhattan-grid.h"
+
+struct Coord {
+    int x;
+    int y;
+};
+
+void testAgainstAllPairs() {
+    std::mt19937 random(4);
+    for (int round = 0; round < 200; ++ round) {
+        int side = 1 + random() % 100;
+        std::uniform_int_distribution<int> coordinate(-side, side);
+        std::vector<Coord> from(random() % 60), to(random() % 60);
+        for (auto & p : from) p = {coordinate(random), coordinate(random)};
+        for (auto & p : to) p = {coordinate(random), coordinate(random)};
+        long reach = random() % (side + 2);
+
+        std::set<std::pair<int, int>> expected, found;
+        for (size_t i = 0; i < from.size(); ++ i) {
+            for (size_t j = 0; j < to.size(); ++ j) {
+                if (std::abs(from[i].x - to[j].x) + std::abs(from[i].y - to[j].y) <= reach) {
+                    expected.insert({i, j});
+                }
+            }
+        }
+        size_t emitted = 0;
+        manhattanPairs(from, to, reach, [&](int i, int j) {
+            found.insert({i, j});
+            ++ emitted;
+        });
+        assert(emitted == found.size());
+        assert(found == expected);
+    }
+}
+
+int main () {
+    testAgainstAllPairs();
+}
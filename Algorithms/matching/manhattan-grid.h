@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Calls emit(i, j) for every point i of `from` and point j of `to` within
+// Manhattan distance reach, without trying all the pairs. Rotating by 45
+// degrees (u = x + y, v = x - y) turns the Manhattan ball into the Chebyshev
+// square max(|du|, |dv|) <= reach, so points of `to` are bucketed into square
+// cells of side reach + 1 and only the 3 x 3 cells around a point of `from`
+// are checked. Cells are sorted by (u cell, v cell), each row of three cells
+// is one binary search and a contiguous scan: O((|from| + |to|) log |to| +
+// candidates), candidates being within a constant factor of the output for
+// evenly spread points. Point needs integer members x and y.
+template <class Point, class Emit>
+void manhattanPairs(const std::vector<Point> & from, const std::vector<Point> & to, long reach, Emit emit) {
+    if (reach < 0) return;
+    const long side = reach + 1;
+    // floor division, rotated coordinates may be negative
+    auto cell = [side](long c) { return c >= 0 ? c / side : -((-c + side - 1) / side); };
+    auto key = [&](const Point & p) {
+        return std::pair<long, long>(cell((long)p.x + p.y), cell((long)p.x - p.y));
+    };
+
+    std::vector<std::pair<std::pair<long, long>, int>> cells(to.size());
+    for (size_t j = 0; j < to.size(); ++ j) {
+        cells[j] = {key(to[j]), (int)j};
+    }
+    std::sort(cells.begin(), cells.end());
+
+    for (size_t i = 0; i < from.size(); ++ i) {
+        const Point & p = from[i];
+        auto [cu, cv] = key(p);
+        for (long u = cu - 1; u <= cu + 1; ++ u) {
+            auto it = std::lower_bound(cells.begin(), cells.end(), std::pair(std::pair(u, cv - 1), -1));
+            for (; it != cells.end() && it->first.first == u && it->first.second <= cv + 1; ++ it) {
+                const Point & q = to[it->second];
+                if (std::abs((long)p.x - q.x) + std::abs((long)p.y - q.y) <= reach) {
+                    emit((int)i, it->second);
+                }
+            }
+        }
+    }
+}
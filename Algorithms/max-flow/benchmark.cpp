@@ -0,0 +1,283 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "dinitz-basic.h"
+#include "dinitz.h"
+#include "edmonds-karp.h"
+#include "push-relabel.h"
+#include "parallel-push-relabel.h"
+
+// Compares max flow implementations on synthetic networks.
+// Usage: ./a.out [-u] [-c copies] [-w] [-r] [file in the Download Speed format ...]
+//   -u         edges of the files are undirected (Fast Maximum Flow)
+//   -c copies  scale the files up by joining that many copies of the network
+//   -w         spread the capacities over 1 .. 1e15
+//   -r         re-solve after a few capacity changes instead, reoptimize vs cold solve
+
+struct Instance {
+    std::string name;
+    int N;
+    int source, target;
+    struct Edge { int from, to; long capacity; };
+    std::vector<Edge> edges;
+};
+
+// Layers of `width` nodes, each node connected to `degree` random nodes of the next layer.
+Instance layered(int layers, int width, int degree, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> pick(0, width - 1);
+    std::uniform_int_distribution<long> capacity(1, 1000000);
+
+    Instance instance{"layered " + std::to_string(layers) + "x" + std::to_string(width), layers * width + 2, 0, layers * width + 1, {}};
+    auto node = [&](int layer, int i) { return 1 + layer * width + i; };
+    for (int i = 0; i < width; ++ i) {
+        instance.edges.push_back({instance.source, node(0, i), capacity(random)});
+        instance.edges.push_back({node(layers - 1, i), instance.target, capacity(random)});
+    }
+    for (int layer = 0; layer + 1 < layers; ++ layer) {
+        for (int i = 0; i < width; ++ i) {
+            for (int d = 0; d < degree; ++ d) {
+                instance.edges.push_back({node(layer, i), node(layer + 1, pick(random)), capacity(random)});
+            }
+        }
+    }
+    return instance;
+}
+
+// `chains` long parallel paths with occasional rungs between them, the deep
+// level graphs which Download Speed tests are made of.
+Instance chains(int chains, int length, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<long> capacity(1, 1000);
+
+    Instance instance{"chains " + std::to_string(chains) + "x" + std::to_string(length), chains * length + 2, 0, chains * length + 1, {}};
+    auto node = [&](int chain, int i) { return 1 + chain * length + i; };
+    for (int c = 0; c < chains; ++ c) {
+        instance.edges.push_back({instance.source, node(c, 0), Dinitz::INF});
+        for (int i = 0; i + 1 < length; ++ i) {
+            instance.edges.push_back({node(c, i), node(c, i + 1), capacity(random)});
+            if (random() % 8 == 0) {
+                instance.edges.push_back({node(c, i), node((c + 1) % chains, i + 1), capacity(random)});
+            }
+        }
+        instance.edges.push_back({node(c, length - 1), instance.target, Dinitz::INF});
+    }
+    return instance;
+}
+
+// Random dense network, every ordered pair of nodes is an edge with the given probability.
+Instance dense(int N, double density, unsigned seed) {
+    std::mt19937 random(seed);
+    std::bernoulli_distribution edge(density);
+    std::uniform_int_distribution<long> capacity(1, 1000000);
+
+    Instance instance{"dense " + std::to_string(N), N, 0, N - 1, {}};
+    for (int a = 0; a < N; ++ a) {
+        for (int b = 0; b < N; ++ b) {
+            if (a != b && edge(random)) {
+                instance.edges.push_back({a, b, capacity(random)});
+            }
+        }
+    }
+    return instance;
+}
+
+// Copies of the network sharing the source and the target, neighbouring copies
+// are linked by a rung for every eighth edge.
+Instance replicate(const Instance & original, int copies, unsigned seed) {
+    std::mt19937 random(seed);
+    int N = original.N;
+    Instance instance{original.name + " x" + std::to_string(copies), copies * N, original.source, original.target, {}};
+    auto node = [&](int copy, int v) {
+        return v == original.source || v == original.target ? v : copy * N + v;
+    };
+    for (int copy = 0; copy < copies; ++ copy) {
+        for (const auto & edge : original.edges) {
+            instance.edges.push_back({node(copy, edge.from), node(copy, edge.to), edge.capacity});
+            if (copies > 1 && random() % 8 == 0) {
+                instance.edges.push_back({node(copy, edge.from), node((copy + 1) % copies, edge.to), edge.capacity});
+            }
+        }
+    }
+    return instance;
+}
+
+// Multiplies every capacity by a random power of ten, capped at 1e15.
+Instance spread(Instance instance, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> exponent(0, 15);
+    const long limit = 1000000000000000L;
+    instance.name += " wide";
+    for (auto & edge : instance.edges) {
+        if (edge.capacity >= limit) continue;
+        for (int e = exponent(random); e > 0 && edge.capacity <= limit / 10; -- e) {
+            edge.capacity *= 10;
+        }
+        edge.capacity = std::min(edge.capacity, limit);
+    }
+    return instance;
+}
+
+bool downloadSpeed(const std::string & path, bool undirected, Instance & instance) {
+    std::ifstream in(path);
+    int M;
+    if (!(in >> instance.N >> M)) return false;
+    instance.name = path;
+    instance.source = 0;
+    instance.target = instance.N - 1;
+    while (M -- > 0) {
+        Instance::Edge edge;
+        if (!(in >> edge.from >> edge.to >> edge.capacity)) return false;
+        instance.edges.push_back({edge.from - 1, edge.to - 1, edge.capacity});
+        if (undirected) {
+            instance.edges.push_back({edge.to - 1, edge.from - 1, edge.capacity});
+        }
+    }
+    return true;
+}
+
+template <class Network, class... Args>
+void run(const std::string & name, const Instance & instance, Args... args) {
+    Network network(instance.N, args...);
+    for (const auto & edge : instance.edges) {
+        network.addEdge(edge.from, edge.to, edge.capacity);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    long flow = network.maxFlow(instance.source, instance.target);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << std::setw(14) << name
+              << std::setw(20) << flow
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count();
+    if constexpr (requires { network.phases(); }) {
+        std::cout << std::setw(8) << network.phases()
+                  << std::setw(14) << std::setprecision(4) << elapsed.count() / std::max<size_t>(1, network.phases());
+    }
+    std::cout << "\n";
+}
+
+void compare(const Instance & instance) {
+    std::cout << instance.name << " (" << instance.N << " nodes, " << instance.edges.size() << " edges)\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(20) << "flow" << std::setw(12) << "total ms"
+              << std::setw(8) << "phases" << std::setw(14) << "ms / phase" << "\n";
+    run<DinitzBasic>("recursive", instance);
+    run<Dinitz>("iterative", instance);
+    run<Dinitz>("scaling", instance, true);
+    run<PushRelabel>("hlpp", instance);
+    for (unsigned threads = 1; threads <= std::max(1u, std::thread::hardware_concurrency()); threads *= 2) {
+        run<ParallelPushRelabel>("parallel x" + std::to_string(threads), instance, threads);
+    }
+    std::cout << "\n";
+}
+
+// Changes a few random capacities (0 to twice the old one) per round and
+// compares reoptimize of the solved network with solving a new one.
+template <class Network>
+void resolve(const std::string & name, Instance instance, int rounds, int changes) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> pick(0, instance.edges.size() - 1);
+
+    Network network(instance.N);
+    for (const auto & edge : instance.edges) {
+        network.addEdge(edge.from, edge.to, edge.capacity);
+    }
+    network.maxFlow(instance.source, instance.target);
+
+    double warm = 0, cold = 0;
+    for (int round = 0; round < rounds; ++ round) {
+        for (int i = 0; i < changes; ++ i) {
+            int edge = pick(random);
+            long & capacity = instance.edges[edge].capacity;
+            capacity = std::uniform_int_distribution<long>(0, 2 * std::min(capacity, Network::INF / 4))(random);
+            network.setCapacity(edge, capacity);
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        long flow = network.reoptimize(instance.source, instance.target);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+        warm += elapsed.count();
+
+        Network fresh(instance.N);
+        for (const auto & edge : instance.edges) {
+            fresh.addEdge(edge.from, edge.to, edge.capacity);
+        }
+        begin = std::chrono::steady_clock::now();
+        long expected = fresh.maxFlow(instance.source, instance.target);
+        elapsed = std::chrono::steady_clock::now() - begin;
+        cold += elapsed.count();
+
+        if (flow != expected) {
+            std::cerr << name << ": reoptimize gives " << flow << " instead of " << expected << "\n";
+        }
+    }
+
+    std::cout << std::setw(14) << name
+              << std::setw(14) << std::fixed << std::setprecision(3) << cold / rounds
+              << std::setw(14) << warm / rounds << "\n";
+}
+
+void compareResolve(const Instance & instance) {
+    const int rounds = 20, changes = 5;
+    std::cout << instance.name << " (" << instance.N << " nodes, " << instance.edges.size() << " edges), "
+              << changes << " changes per round\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(14) << "cold ms" << std::setw(14) << "warm ms" << "\n";
+    if (instance.edges.size() < 100000) {
+        resolve<EdmondsKarp>("edmonds-karp", instance, rounds, changes);
+    }
+    resolve<Dinitz>("dinitz", instance, rounds, changes);
+    resolve<PushRelabel>("hlpp", instance, rounds, changes);
+    std::cout << "\n";
+}
+
+int main (int argc, char * argv[]) {
+    bool undirected = false;
+    bool reoptimize = false;
+    bool wide = false;
+    int copies = 1;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++ i) {
+        std::string arg = argv[i];
+        if (arg == "-u") undirected = true;
+        else if (arg == "-r") reoptimize = true;
+        else if (arg == "-w") wide = true;
+        else if (arg == "-c" && i + 1 < argc) copies = std::stoi(argv[++ i]);
+        else files.push_back(arg);
+    }
+
+    if (!files.empty()) {
+        for (const auto & file : files) {
+            Instance instance;
+            if (!downloadSpeed(file, undirected, instance)) {
+                std::cerr << "Invalid input " << file << ".\n";
+                return 1;
+            }
+            if (copies > 1) instance = replicate(instance, copies, 6);
+            if (wide) instance = spread(instance, 8);
+            if (reoptimize) compareResolve(instance);
+            else compare(instance);
+        }
+        return 0;
+    }
+
+    if (reoptimize) {
+        compareResolve(layered(20, 200, 4, 1));
+        compareResolve(layered(100, 1000, 4, 1));
+        compareResolve(dense(1000, 0.5, 4));
+        return 0;
+    }
+
+    compare(layered(100, 1000, 4, 1));
+    compare(layered(1000, 100, 4, 2));
+    compare(chains(16, 20000, 3));
+    compare(dense(1000, 0.5, 4));
+    compare(dense(3000, 0.1, 5));
+    compare(spread(layered(100, 1000, 4, 1), 8));
+    compare(spread(chains(16, 20000, 3), 8));
+}
@@ -1,110 +1,65 @@
-#include <vector>
-#include <deque>
-#include <iostream>
-#include <set>
+#include <cassert>
+#include <cstdint>
 
-#include "flow-network.h"
+#include "dinitz.h"
 
+#include "flow-network-test.h"
 
-class Dinitz : public FlowNetwork {
-    public: 
-        Dinitz(size_t noNodes);
-        void addEdge(int a, int b, long cap) override;
-        long maxFlow(int source, int target) override;
-
-        struct Edge {
-            int from, to;
-            long capacity, cost, flow = 0;
-
-            long residue() const {
-                return capacity - flow;
-            }
-        };
-
-    private:
-        long dfs_and_cleanup(int source, int target, long flow = INF);
-        bool bfs(int source, int target);
-
-        std::vector<std::vector<int>> m_adjacent;
-        std::vector<std::vector<int>> m_clean_adjacent;
-        std::vector<Edge> m_edges;
-};
-
-Dinitz::Dinitz(size_t noNodes) 
-: m_adjacent(noNodes)
-{
-}
+void testAddEdgeAfterMaxFlow() {
+    Dinitz network(4);
+    network.addEdge(0, 1, 3);
+    network.addEdge(1, 3, 2);
+    assert(network.maxFlow(0, 3) == 2);
 
-void Dinitz::addEdge(int a, int b, long cap) {
-    auto m = m_edges.size();
-    m_edges.push_back(Edge{a, b, cap, 0, 0});
-    m_adjacent[a].push_back(m);
-    m_edges.push_back(Edge{b, a, 0, 0, 0});
-    m_adjacent[b].push_back(m + 1);
+    // repacking keeps the flow already found
+    network.addEdge(1, 2, 5);
+    network.addEdge(2, 3, 4);
+    assert(network.maxFlow(0, 3) == 1);
 }
 
-bool Dinitz::bfs(int start, int target) {
-    size_t N = m_adjacent.size();
-    std::vector<long> distance(N, INF);
-    m_clean_adjacent.assign(N, {});
-    std::deque<int> queue = {start};
-    distance[start] = 0;
-
-    while (!queue.empty()) {
-        int current = queue.front();
-        queue.pop_front();
-
-        if (distance[current] + 1 > distance[target]) break;
-
-        for (int idx : m_adjacent[current]) {
-            Edge edge = m_edges[idx];
-            if (edge.residue() > 0 && distance[edge.from] < distance[edge.to]) {
-                m_clean_adjacent[edge.from].push_back(idx);
-                if (distance[edge.to] == INF) { // not visited
-                    distance[edge.to] = distance[edge.from] + 1;
-                    queue.push_back(edge.to);
-                }
-            }
-        }
-    }
-
-    return distance[target] != INF;
-}
+// Dinitz with scaling, for the generic tests
+struct ScalingDinitz : Dinitz {
+    ScalingDinitz(size_t noNodes) : Dinitz(noNodes, true) {}
+};
 
-long Dinitz::dfs_and_cleanup(int node, int target, long flow) {
-    if (!flow || node == target) {
-        return flow;
-    }
-    for (int i = m_clean_adjacent[node].size() -1; i >= 0; -- i) {
-        int idx = m_clean_adjacent[node][i];
-        Edge edge = m_edges[idx];
-        if (edge.residue() > 0) {
-            long path_flow = dfs_and_cleanup(edge.to, target, std::min(flow, edge.residue()));
-            if (path_flow > 0) {
-                m_edges[idx].flow += path_flow;
-                m_edges[idx ^ 1].flow -= path_flow;
-                return path_flow;
-            }
-        }
-        m_clean_adjacent[node].pop_back();
-    }
-    return 0;
+void testWideCapacities() {
+    Dinitz network(4, true);
+    network.addEdge(0, 1, 1000000000000000L);
+    network.addEdge(0, 2, 3);
+    network.addEdge(1, 2, 1);
+    network.addEdge(1, 3, 999999999999998L);
+    network.addEdge(2, 3, 5);
+    assert(network.maxFlow(0, 3) == 999999999999998L + 4);
 }
 
-long Dinitz::maxFlow(int start, int target) {
-    long flow = 0;
-    while (bfs(start, target)) {
-        long path_flow;
-        while ((path_flow = dfs_and_cleanup(start, target, INF))) {
-            flow += path_flow;
-        }
+// 2^64 units of flow overflow long, not __int128
+void testWideType() {
+    BasicDinitz<__int128> network(3);
+    for (int i = 0; i < 16; ++ i) {
+        network.addEdge(0, 1, Dinitz::INF);
+        network.addEdge(1, 2, Dinitz::INF);
     }
-
-    return flow;
+    assert(network.maxFlow(0, 2) == (__int128)16 * Dinitz::INF);
 }
 
-#include "flow-network-test.h"
-
 int main () {
     testMaxFlow<Dinitz>();
+    testMinCut<Dinitz>();
+    testDecomposition<Dinitz>();
+    testReoptimize<Dinitz>();
+    testAddEdgeAfterMaxFlow();
+
+    testMaxFlow<ScalingDinitz>();
+    testMinCut<ScalingDinitz>();
+    testDecomposition<ScalingDinitz>();
+    testReoptimize<ScalingDinitz>();
+    testWideCapacities();
+
+    testMaxFlow<BasicDinitz<int32_t>>();
+    testMinCut<BasicDinitz<int32_t>>();
+    testDecomposition<BasicDinitz<int32_t>>();
+    testReoptimize<BasicDinitz<int32_t>>();
+    testLargeFlow<BasicDinitz<int32_t>>();
+    testMaxFlow<BasicDinitz<__int128>>();
+    testWideType();
 }
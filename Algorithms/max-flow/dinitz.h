@@ -0,0 +1,252 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <limits>
+
+#include "flow-network.h"
+#include "residual-graph.h"
+
+// Build-then-freeze Dinitz on the CSR residual graph. addEdge only records the
+// edge, maxFlow freezes the graph first; edges added after maxFlow are packed
+// by the next maxFlow keeping the flow found so far.
+// Each phase finds a blocking flow of the level graph in a single iterative
+// traversal: the current path lives on an explicit stack, after augmenting
+// it retreats only to the tail of the first saturated arc and dead ends are
+// removed from the level graph, so every arc is advanced at most once per phase.
+// Edges are numbered in the order they were added. setCapacity changes an edge
+// of a solved network and reoptimize repairs the flow instead of starting over:
+// changes are applied one by one, flow which no longer fits an edge is rerouted
+// around it or cancelled back to the source and from the target, then the flow
+// is augmented again.
+// With scaling enabled the phases run on arcs with residue of at least delta
+// only, delta starting at the largest power of two not above the largest
+// capacity and halved whenever no path is left. Each scale needs only a few
+// phases of long paths with big bottlenecks, which pays off when capacities
+// span many orders of magnitude.
+template <class Cap>
+class BasicDinitz : public BasicFlowNetwork<Cap> {
+        using typename BasicFlowNetwork<Cap>::CapacityChange;
+    public:
+        using BasicFlowNetwork<Cap>::INF;
+
+        BasicDinitz(size_t noNodes, bool scaling = false);
+        void addEdge(int a, int b, Cap cap) override;
+        Cap maxFlow(int source, int target) override;
+        size_t phases() const { return m_phases; }
+
+        void setCapacity(int edge, Cap cap);
+        Cap reoptimize(int source, int target);
+
+        MinCut minCut() const;
+        std::span<const typename BasicResidualGraph<Cap>::Edge> edges() const { return m_graph.edges; }
+        std::vector<Cap> flows() const;
+        std::vector<BasicFlowPath<Cap>> decompose() const;
+
+    private:
+        void freeze();
+        void applyChanges(int source, int target);
+        Cap augment(int source, int target, Cap limit);
+        Cap blockingFlow(int source, int target, Cap limit);
+        bool bfs(int source, int target);
+
+        BasicResidualGraph<Cap> m_graph;
+        int m_source = 0, m_target = 0;
+        std::vector<CapacityChange> m_changes;
+
+        // phase buffers, reused across phases
+        std::vector<int> m_distance;
+        std::vector<int> m_current; // first arc of the level graph not yet exhausted
+        std::vector<int> m_queue;
+        std::vector<int> m_path; // arcs from the source to the current node
+        size_t m_phases = 0;
+        bool m_scaling;
+        Cap m_delta = 1; // smallest residue of an admissible arc
+};
+
+template <class Cap>
+inline BasicDinitz<Cap>::BasicDinitz(size_t noNodes, bool scaling)
+: m_graph(noNodes)
+, m_scaling(scaling)
+{
+}
+
+template <class Cap>
+inline void BasicDinitz<Cap>::addEdge(int a, int b, Cap cap) {
+    m_graph.addEdge(a, b, cap);
+}
+
+template <class Cap>
+inline void BasicDinitz<Cap>::freeze() {
+    m_graph.freeze();
+    size_t N = m_graph.nodes;
+    m_distance.resize(N);
+    m_current.resize(N);
+    m_queue.resize(N);
+    m_path.reserve(N);
+}
+
+template <class Cap>
+inline bool BasicDinitz<Cap>::bfs(int start, int target) {
+    std::fill(m_distance.begin(), m_distance.end(), -1);
+    size_t head = 0, tail = 0;
+    m_queue[tail ++] = start;
+    m_distance[start] = 0;
+
+    while (head < tail) {
+        int current = m_queue[head ++];
+
+        if (m_distance[target] != -1 && m_distance[current] + 1 > m_distance[target]) break;
+
+        for (int arc = m_graph.offset[current]; arc < m_graph.offset[current + 1]; ++ arc) {
+            int next = m_graph.to[arc];
+            if (m_graph.residue[arc] >= m_delta && m_distance[next] == -1) {
+                m_distance[next] = m_distance[current] + 1;
+                m_queue[tail ++] = next;
+            }
+        }
+    }
+
+    return m_distance[target] != -1;
+}
+
+template <class Cap>
+inline Cap BasicDinitz<Cap>::blockingFlow(int start, int target, Cap limit) {
+    std::copy(m_graph.offset.begin(), m_graph.offset.end() - 1, m_current.begin());
+    m_path.clear();
+    Cap flow = 0;
+    int node = start;
+
+    while (flow < limit) {
+        if (node == target) {
+            Cap path_flow = limit - flow;
+            for (int arc : m_path) {
+                path_flow = std::min(path_flow, m_graph.residue[arc]);
+            }
+            size_t saturated = m_path.size();
+            for (size_t i = 0; i < m_path.size(); ++ i) {
+                int arc = m_path[i];
+                m_graph.residue[arc] -= path_flow;
+                m_graph.residue[m_graph.reverse[arc]] += path_flow;
+                if (m_graph.residue[arc] < m_delta && saturated == m_path.size()) saturated = i;
+            }
+            flow += path_flow;
+            // continue from the tail of the first saturated arc
+            m_path.resize(saturated);
+            node = m_path.empty() ? start : m_graph.to[m_path.back()];
+            continue;
+        }
+
+        // advance
+        int & arc = m_current[node];
+        int end = m_graph.offset[node + 1];
+        while (arc < end && (m_graph.residue[arc] < m_delta || m_distance[m_graph.to[arc]] != m_distance[node] + 1)) {
+            ++ arc;
+        }
+        if (arc < end) {
+            m_path.push_back(arc);
+            node = m_graph.to[arc];
+            continue;
+        }
+
+        // retreat, node is a dead end for the rest of the phase
+        if (node == start) break;
+        m_distance[node] = -1;
+        m_path.pop_back();
+        node = m_path.empty() ? start : m_graph.to[m_path.back()];
+        ++ m_current[node];
+    }
+
+    return flow;
+}
+
+template <class Cap>
+inline Cap BasicDinitz<Cap>::augment(int start, int target, Cap limit) {
+    if (start == target) return limit;
+
+    Cap delta = 1;
+    if (m_scaling) {
+        // no path carries more than the widest arc leaving the start
+        Cap largest = 0;
+        for (int arc = m_graph.offset[start]; arc < m_graph.offset[start + 1]; ++ arc) {
+            largest = std::max(largest, m_graph.residue[arc]);
+        }
+        largest = std::min(largest, limit);
+        while (delta <= largest / 2) delta *= 2;
+    }
+
+    Cap flow = 0;
+    for (m_delta = delta; m_delta >= 1 && flow < limit; m_delta /= 2) {
+        while (flow < limit && bfs(start, target)) {
+            ++ m_phases;
+            flow += blockingFlow(start, target, limit - flow);
+        }
+    }
+    m_delta = 1;
+
+    return flow;
+}
+
+template <class Cap>
+inline Cap BasicDinitz<Cap>::maxFlow(int start, int target) {
+    if (!m_graph.frozen) freeze();
+    m_source = start;
+    m_target = target;
+    applyChanges(start, target);
+
+    return augment(start, target, std::numeric_limits<Cap>::max());
+}
+
+template <class Cap>
+inline void BasicDinitz<Cap>::setCapacity(int edge, Cap cap) {
+    m_changes.push_back(CapacityChange{edge, cap});
+}
+
+// Returns the value of the max flow after the capacity changes.
+template <class Cap>
+inline Cap BasicDinitz<Cap>::reoptimize(int source, int target) {
+    if (!m_graph.frozen) freeze();
+    m_source = source;
+    m_target = target;
+    applyChanges(source, target);
+
+    augment(source, target, std::numeric_limits<Cap>::max());
+    return m_graph.flowInto(target);
+}
+
+template <class Cap>
+inline void BasicDinitz<Cap>::applyChanges(int source, int target) {
+    for (const CapacityChange & change : m_changes) {
+        Cap overflow = m_graph.setCapacity(change.edge, change.capacity);
+        if (overflow == 0) continue;
+
+        const auto & edge = m_graph.edges[change.edge];
+        this->repair(edge.from, edge.to, overflow, source, target, [&](int start, int end, Cap limit) {
+            return augment(start, end, limit);
+        });
+    }
+    m_changes.clear();
+}
+
+// Min cut of the last maxFlow or reoptimize.
+template <class Cap>
+inline MinCut BasicDinitz<Cap>::minCut() const {
+    return m_graph.minCut(m_source, m_target, false);
+}
+
+// Flow of every edge in addEdge order.
+template <class Cap>
+inline std::vector<Cap> BasicDinitz<Cap>::flows() const {
+    std::vector<Cap> flows;
+    m_graph.gatherFlows(flows);
+    return flows;
+}
+
+// Paths from the source to the target and cycles of the last maxFlow or reoptimize.
+template <class Cap>
+inline std::vector<BasicFlowPath<Cap>> BasicDinitz<Cap>::decompose() const {
+    return decomposeFlow<typename BasicResidualGraph<Cap>::Edge>(m_graph.nodes, m_source, m_target, m_graph.edges, flows());
+}
+
+using Dinitz = BasicDinitz<long>;
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <limits>
+
+#include "flow-network.h"
+
+// parallel edges, counter edges
+// Edges are numbered in the order they were added, setCapacity and reoptimize
+// work as in Dinitz.
+template <class Cap>
+class BasicEdmondsKarp : public BasicFlowNetwork<Cap> {
+        using typename BasicFlowNetwork<Cap>::CapacityChange;
+    public:
+        using BasicFlowNetwork<Cap>::INF;
+
+        BasicEdmondsKarp(size_t noNodes);
+        void addEdge(int a, int b, Cap cap) override;
+        Cap maxFlow(int source, int target) override;
+
+        void setCapacity(int edge, Cap cap);
+        Cap reoptimize(int source, int target);
+
+        MinCut minCut() const;
+
+        struct Edge {
+            int from, to;
+            Cap capacity, flow = 0, cost;
+
+            Cap residue() const {
+                return capacity - flow;
+            }
+        };
+
+    private:
+        void applyChanges(int source, int target);
+        Cap augment(int source, int target, Cap limit);
+        Cap augmentingPath(int source, int target, std::vector<int> & parent) const;
+
+        std::vector<std::vector<int>> m_adjacent;
+        std::vector<Edge> m_edges;
+        int m_source = 0;
+        std::vector<CapacityChange> m_changes;
+};
+
+template <class Cap>
+inline BasicEdmondsKarp<Cap>::BasicEdmondsKarp(size_t noNodes) 
+: m_adjacent(noNodes)
+{
+}
+
+template <class Cap>
+inline void BasicEdmondsKarp<Cap>::addEdge(int a, int b, Cap cap) {
+    auto m = m_edges.size();
+    m_edges.push_back(Edge{a, b, cap, 0, 0});
+    m_adjacent[a].push_back(m ++);
+    m_edges.push_back(Edge{b, a, 0, 0, 0});
+    m_adjacent[b].push_back(m);
+}
+
+template <class Cap>
+inline Cap BasicEdmondsKarp<Cap>::maxFlow(int source, int target) {
+    m_source = source;
+    applyChanges(source, target);
+    return augment(source, target, std::numeric_limits<Cap>::max());
+}
+
+template <class Cap>
+inline Cap BasicEdmondsKarp<Cap>::augment(int source, int target, Cap limit) {
+    if (source == target) return limit;
+
+    Cap flow = 0;
+    std::vector<int>parent(m_adjacent.size());
+    Cap path_flow;
+    while (flow < limit && (path_flow = augmentingPath(source, target, parent)) > 0 ) {
+        path_flow = std::min(path_flow, limit - flow);
+        flow += path_flow;
+        // std::cerr << "augmenting path " << path_flow << ": ";
+        for (int current = target; current != source; ) {
+            int id = parent[current];
+            m_edges[id].flow += path_flow;
+            m_edges[id ^ 1].flow -= path_flow;
+            // std::cerr << current << " -> " << m_edges[id].from << " ";
+            current = m_edges[id].from;
+        }
+        // std::cerr << "\n";
+    }
+
+    return flow;
+}
+
+template <class Cap>
+inline Cap BasicEdmondsKarp<Cap>::augmentingPath(int source, int target, std::vector<int> & parent) const{
+    parent.assign(parent.size(), -1);
+    parent[source] = -2;
+    std::deque<std::pair<int, Cap>> q({{source, std::numeric_limits<Cap>::max()}});
+
+    while (!q.empty()) {
+        auto [current, flow] = q.front();
+        q.pop_front();
+
+        for (int idx : m_adjacent[current]) {
+            auto e = m_edges[idx];
+            if (parent[e.to] == -1 && e.residue() > 0) {
+                Cap local_flow = std::min(flow, e.residue());
+                parent[e.to] = idx;
+                if (e.to == target) return local_flow;
+                q.push_back({e.to, local_flow});
+            }
+        }
+    }
+
+    return 0;
+}
+
+template <class Cap>
+inline void BasicEdmondsKarp<Cap>::setCapacity(int edge, Cap cap) {
+    m_changes.push_back(CapacityChange{edge, cap});
+}
+
+// Returns the value of the max flow after the capacity changes.
+template <class Cap>
+inline Cap BasicEdmondsKarp<Cap>::reoptimize(int source, int target) {
+    m_source = source;
+    applyChanges(source, target);
+    augment(source, target, std::numeric_limits<Cap>::max());
+
+    Cap flow = 0;
+    for (int idx : m_adjacent[target]) {
+        flow -= m_edges[idx].flow;
+    }
+    return flow;
+}
+
+template <class Cap>
+inline void BasicEdmondsKarp<Cap>::applyChanges(int source, int target) {
+    for (const CapacityChange & change : m_changes) {
+        Edge & forward = m_edges[2 * change.edge];
+        Cap overflow = std::max(Cap(0), forward.flow - change.capacity);
+        forward.capacity = change.capacity;
+        forward.flow -= overflow;
+        m_edges[2 * change.edge + 1].flow += overflow;
+        if (overflow == 0) continue;
+
+        this->repair(forward.from, forward.to, overflow, source, target, [&](int start, int end, Cap limit) {
+            return augment(start, end, limit);
+        });
+    }
+    m_changes.clear();
+}
+
+// Min cut of the last maxFlow or reoptimize, nodes reachable from the source.
+template <class Cap>
+inline MinCut BasicEdmondsKarp<Cap>::minCut() const {
+    MinCut cut;
+    std::vector<bool> seen(m_adjacent.size(), false);
+    std::vector<int> stack = {m_source};
+    seen[m_source] = true;
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && !seen[edge.to]) {
+                seen[edge.to] = true;
+                stack.push_back(edge.to);
+            }
+        }
+    }
+
+    for (size_t idx = 0; idx < m_edges.size(); idx += 2) {
+        if (seen[m_edges[idx].from] && !seen[m_edges[idx].to]) {
+            cut.edges.push_back(idx / 2);
+        }
+    }
+    cut.sourceSide = std::move(seen);
+    return cut;
+}
+
+using EdmondsKarp = BasicEdmondsKarp<long>;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <algorithm>
+
+// Part of a flow decomposition: edges (in addEdge order) of a path from the
+// source to the target, or of a cycle, each carrying the same flow.
+template <class Cap>
+struct BasicFlowPath {
+    Cap flow;
+    bool cycle;
+    std::vector<int> edges;
+};
+
+using FlowPath = BasicFlowPath<long>;
+
+// Splits a flow into at most as many paths and cycles as there are edges with
+// flow. Walks from the source (later from any node with flow left) along
+// edges with flow, a walk ends at the target or when it closes a cycle, then
+// the bottleneck is taken off and at least one edge runs dry. Every walk is
+// O(V) apart from skipping dry edges, which happens once per edge: O(V E).
+template <class Edge, class Cap>
+std::vector<BasicFlowPath<Cap>> decomposeFlow(size_t nodes, int source, int target, std::span<const Edge> edges, std::vector<Cap> flow) {
+    // edges with flow by their tail
+    std::vector<int> offset(nodes + 1, 0);
+    for (size_t i = 0; i < edges.size(); ++ i) {
+        if (flow[i] > 0) ++ offset[edges[i].from + 1];
+    }
+    for (size_t v = 0; v < nodes; ++ v) {
+        offset[v + 1] += offset[v];
+    }
+    std::vector<int> out(offset.back());
+    std::vector<int> current(offset.begin(), offset.end() - 1);
+    for (size_t i = 0; i < edges.size(); ++ i) {
+        if (flow[i] > 0) out[current[edges[i].from] ++] = i;
+    }
+    std::copy(offset.begin(), offset.end() - 1, current.begin());
+
+    auto nextEdge = [&](int node) {
+        while (current[node] < offset[node + 1] && flow[out[current[node]]] == 0) ++ current[node];
+        return current[node] < offset[node + 1] ? out[current[node]] : -1;
+    };
+
+    std::vector<BasicFlowPath<Cap>> result;
+    std::vector<int> walk;              // edges of the current walk
+    std::vector<int> onWalk(nodes, -1); // index in the walk of the edge leaving the node
+    auto takeOff = [&](size_t from, bool cycle) {
+        BasicFlowPath<Cap> path{flow[walk[from]], cycle, {walk.begin() + from, walk.end()}};
+        for (int edge : path.edges) path.flow = std::min(path.flow, flow[edge]);
+        for (int edge : path.edges) {
+            flow[edge] -= path.flow;
+            onWalk[edges[edge].from] = -1;
+        }
+        walk.resize(from);
+        result.push_back(std::move(path));
+    };
+    // cycles are taken off on the way, a walk towards the target stops there,
+    // returns whether anything was taken off
+    auto walkFrom = [&](int node, bool toTarget) {
+        size_t found = result.size();
+        while (true) {
+            if (toTarget && node == target) {
+                takeOff(0, false);
+                return true;
+            }
+            if (onWalk[node] != -1) takeOff(onWalk[node], true);
+            int edge = nextEdge(node);
+            if (edge == -1) {
+                // only at the start, unless conservation does not hold
+                for (int e : walk) onWalk[edges[e].from] = -1;
+                walk.clear();
+                return result.size() > found;
+            }
+            onWalk[node] = walk.size();
+            walk.push_back(edge);
+            node = edges[edge].to;
+        }
+    };
+
+    while (nextEdge(source) != -1 && walkFrom(source, true)) {}
+    for (size_t node = 0; node < nodes; ++ node) {
+        if (nextEdge(node) != -1) walkFrom(node, false);
+    }
+
+    return result;
+}
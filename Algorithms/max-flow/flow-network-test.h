@@ -4,8 +4,10 @@
 
 #include <cassert>
 #include <concepts>
+#include <vector>
+#include <tuple>
 
-template <class GraphType> requires std::derived_from<GraphType, FlowNetwork>  
+template <class GraphType> requires std::derived_from<GraphType, BasicFlowNetwork<typename GraphType::Capacity>>
 void testMaxFlow () {
     GraphType network(6);
     network.addEdge(0, 1, 7);
@@ -21,3 +23,109 @@ void testMaxFlow () {
     auto flow = network.maxFlow(0, 5);
     assert(flow == 10);
 }
+
+// The flow is not limited by INF: 2 * 10^9 is far above INF of int32_t, 2^28,
+// and still fits the type.
+template <class GraphType> requires std::derived_from<GraphType, BasicFlowNetwork<typename GraphType::Capacity>>
+void testLargeFlow () {
+    GraphType network(4);
+    network.addEdge(0, 1, 1000000000);
+    network.addEdge(0, 2, 1000000000);
+    network.addEdge(1, 3, 1000000000);
+    network.addEdge(2, 3, 1000000000);
+    network.addEdge(1, 2, 5);
+    assert(network.maxFlow(0, 3) == 2000000000);
+
+    GraphType single(2);
+    single.addEdge(0, 1, 1000000000);
+    assert(single.maxFlow(0, 1) == 1000000000);
+}
+
+template <class GraphType> requires std::derived_from<GraphType, BasicFlowNetwork<typename GraphType::Capacity>>
+void testReoptimize () {
+    std::vector<std::tuple<int, int, long>> edges = {
+        {0, 1, 7}, {1, 2, 5}, {2, 5, 8}, {1, 3, 3}, {0, 4, 4},
+        {4, 1, 3}, {4, 3, 2}, {3, 2, 3}, {3, 5, 5},
+    };
+    auto coldFlow = [&]() {
+        GraphType network(6);
+        for (auto [a, b, cap] : edges) network.addEdge(a, b, cap);
+        return network.maxFlow(0, 5);
+    };
+
+    GraphType network(6);
+    for (auto [a, b, cap] : edges) network.addEdge(a, b, cap);
+    assert(network.maxFlow(0, 5) == 10);
+
+    // {edge, new capacity}, decreases below the flow and increases
+    std::vector<std::pair<int, long>> changes = {{2, 3}, {8, 1}, {2, 8}, {0, 0}, {0, 9}, {4, 10}, {3, 0}, {7, 1}};
+    for (auto [edge, cap] : changes) {
+        std::get<2>(edges[edge]) = cap;
+        network.setCapacity(edge, cap);
+        assert(network.reoptimize(0, 5) == coldFlow());
+    }
+}
+
+template <class GraphType> requires std::derived_from<GraphType, BasicFlowNetwork<typename GraphType::Capacity>>
+void testMinCut () {
+    std::vector<std::tuple<int, int, long>> edges = {
+        {0, 1, 7}, {1, 2, 5}, {2, 5, 8}, {1, 3, 3}, {0, 4, 4},
+        {4, 1, 3}, {4, 3, 2}, {3, 2, 3}, {3, 5, 5},
+    };
+    GraphType network(6);
+    for (auto [a, b, cap] : edges) network.addEdge(a, b, cap);
+    auto flow = network.maxFlow(0, 5);
+
+    auto cut = network.minCut();
+    assert(cut.sourceSide[0] && !cut.sourceSide[5]);
+    long capacity = 0;
+    for (int edge : cut.edges) {
+        auto [a, b, cap] = edges[edge];
+        assert(cut.sourceSide[a] && !cut.sourceSide[b]);
+        capacity += cap;
+    }
+    assert(capacity == flow);
+}
+
+template <class GraphType> requires std::derived_from<GraphType, BasicFlowNetwork<typename GraphType::Capacity>>
+void testDecomposition () {
+    GraphType network(7);
+    network.addEdge(0, 1, 7);
+    network.addEdge(1, 2, 5);
+    network.addEdge(2, 5, 8);
+    network.addEdge(1, 3, 3);
+    network.addEdge(0, 4, 4);
+    network.addEdge(4, 1, 3);
+    network.addEdge(4, 3, 2);
+    network.addEdge(3, 2, 3);
+    network.addEdge(3, 5, 5);
+    // cycle off the paths
+    network.addEdge(2, 6, 1);
+    network.addEdge(6, 2, 1);
+    auto flow = network.maxFlow(0, 5);
+
+    auto flows = network.flows();
+    auto edges = network.edges();
+    std::vector<long> sum(flows.size(), 0);
+    long total = 0;
+    auto paths = network.decompose();
+    assert(paths.size() <= flows.size());
+    for (const auto & path : paths) {
+        assert(path.flow > 0 && !path.edges.empty());
+        for (size_t i = 0; i + 1 < path.edges.size(); ++ i) {
+            assert(edges[path.edges[i]].to == edges[path.edges[i + 1]].from);
+        }
+        int first = edges[path.edges.front()].from, last = edges[path.edges.back()].to;
+        if (path.cycle) {
+            assert(first == last);
+        } else {
+            assert(first == 0 && last == 5);
+            total += path.flow;
+        }
+        for (int edge : path.edges) sum[edge] += path.flow;
+    }
+    assert(total == flow);
+    for (size_t i = 0; i < flows.size(); ++ i) {
+        assert(sum[i] == flows[i]);
+    }
+}
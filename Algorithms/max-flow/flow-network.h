@@ -1,14 +1,55 @@
 #pragma once
 
+#include <vector>
 
-class FlowNetwork {
+// Min cut of a solved network: nodes on the source side and the saturated
+// edges (numbered in addEdge order) leading from there to the other side.
+struct MinCut {
+    std::vector<bool> sourceSide;
+    std::vector<int> edges;
+};
+
+// Capacities and flows are of type Cap, any signed integer: int32_t keeps the
+// arcs of unit capacity graphs compact, __int128 cannot overflow when many
+// INF edges meet in one node. INF is an eighth of the range, so sums of a few
+// INF capacities still fit. It is only a capacity, the flow itself is limited
+// by the range of Cap alone.
+template <class Cap>
+class BasicFlowNetwork {
 public:
-    virtual void addEdge(int a, int b, long cap) = 0;
-    virtual long maxFlow(int source, int target) = 0;
-    virtual ~FlowNetwork() = default;
+    using Capacity = Cap;
 
-    inline static long INF = 1e18; 
+    virtual void addEdge(int a, int b, Cap cap) = 0;
+    virtual Cap maxFlow(int source, int target) = 0;
+    virtual ~BasicFlowNetwork() = default;
 
-};
+    inline static constexpr Cap INF = Cap(1) << (sizeof(Cap) * 8 - 4);
 
+protected:
+    // capacity change waiting for the next solve
+    struct CapacityChange {
+        int edge;
+        Cap capacity;
+    };
+
+    // A capacity cut below the flow of edge from -> to took `overflow` off
+    // it, which leaves excess at the tail and deficit at the head. The flow
+    // is rerouted from the tail to the head first, the terminals absorb what
+    // is left: the tail sends its excess back to the source or on to the
+    // target, the head draws from the target or the source. augment(start,
+    // target, limit) is the solver's own and returns what it moved.
+    template <class Augment>
+    static void repair(int from, int to, Cap overflow, int source, int target, Augment augment) {
+        Cap rest = overflow - augment(from, to, overflow);
+        if (from != source && from != target) {
+            Cap left = rest - augment(from, source, rest);
+            augment(from, target, left);
+        }
+        if (to != source && to != target) {
+            Cap left = rest - augment(target, to, rest);
+            augment(source, to, left);
+        }
+    }
+};
 
+using FlowNetwork = BasicFlowNetwork<long>;
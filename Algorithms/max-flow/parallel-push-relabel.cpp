@@ -0,0 +1,34 @@
+#include <cassert>
+#include <cstdint>
+
+#include "parallel-push-relabel.h"
+
+#include "flow-network-test.h"
+
+// the engine on four threads, also on a single core
+template <class Cap>
+struct FourThreads : BasicParallelPushRelabel<Cap> {
+    FourThreads(size_t noNodes) : BasicParallelPushRelabel<Cap>(noNodes, 4) {}
+};
+
+// 2^64 units of flow overflow long, not __int128, whose atomics are not lock-free
+void testWideType() {
+    FourThreads<__int128> network(3);
+    for (int i = 0; i < 16; ++ i) {
+        network.addEdge(0, 1, ParallelPushRelabel::INF);
+        network.addEdge(1, 2, ParallelPushRelabel::INF);
+    }
+    assert(network.maxFlow(0, 2) == (__int128)16 * ParallelPushRelabel::INF);
+}
+
+int main () {
+    testMaxFlow<ParallelPushRelabel>();
+    testMinCut<ParallelPushRelabel>();
+
+    testMaxFlow<FourThreads<long>>();
+    testMinCut<FourThreads<long>>();
+    testMaxFlow<FourThreads<int32_t>>();
+    testLargeFlow<FourThreads<int32_t>>();
+    testMaxFlow<FourThreads<__int128>>();
+    testWideType();
+}
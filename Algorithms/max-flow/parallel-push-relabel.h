@@ -0,0 +1,292 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <algorithm>
+
+#include "flow-network.h"
+#include "residual-graph.h"
+
+// Excess pushed into a node during a round by any thread. Capacities with
+// lock-free atomics add with fetch_add, wider ones like __int128 under a spin
+// lock of the node.
+template <class Cap, bool LockFree = std::atomic<Cap>::is_always_lock_free>
+class AtomicExcess {
+public:
+    void add(Cap cap) { m_value.fetch_add(cap, std::memory_order_relaxed); }
+    Cap take() { return m_value.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<Cap> m_value = 0;
+};
+
+template <class Cap>
+class AtomicExcess<Cap, false> {
+public:
+    void add(Cap cap) {
+        while (m_lock.test_and_set(std::memory_order_acquire)) {}
+        m_value += cap;
+        m_lock.clear(std::memory_order_release);
+    }
+
+    Cap take() {
+        while (m_lock.test_and_set(std::memory_order_acquire)) {}
+        Cap value = m_value;
+        m_value = 0;
+        m_lock.clear(std::memory_order_release);
+        return value;
+    }
+
+private:
+    std::atomic_flag m_lock;
+    Cap m_value = 0;
+};
+
+// Synchronous parallel push-relabel on the CSR residual graph.
+// Every round all active nodes are discharged in parallel against the heights
+// of the previous round, so for an arc pair only one endpoint may push and the
+// residues need no locking; pushed excess is collected with atomic adds and a
+// node is put on the shared queue of the next round by the first thread which
+// gives it excess. Nodes left with excess are relabeled in a second step, new
+// heights and excesses are published in a third one. Heights are recomputed by
+// a global relabel (reverse BFS from the target) between rounds after a batch
+// of relabel work. Like PushRelabel only the first phase is run.
+template <class Cap>
+class BasicParallelPushRelabel : public BasicFlowNetwork<Cap> {
+    using typename BasicFlowNetwork<Cap>::CapacityChange;
+public:
+    using BasicFlowNetwork<Cap>::INF;
+
+    BasicParallelPushRelabel(int N, unsigned threads = std::thread::hardware_concurrency());
+
+    void addEdge(int a, int b, Cap cap) override;
+    Cap maxFlow(int source, int target) override;
+
+    MinCut minCut() const;
+
+private:
+
+    // runs on one thread between the steps of a round
+    struct RoundStep {
+        BasicParallelPushRelabel * network;
+        void operator()() noexcept { network->roundStep(); }
+    };
+
+    void worker(std::barrier<RoundStep> & sync);
+    void roundStep() noexcept;
+    void pushNodes();
+    void relabelNodes();
+    void applyNodes();
+    void enqueue(int node);
+    void globalRelabel();
+
+    BasicResidualGraph<Cap> m_graph;
+    unsigned m_threads;
+    int m_N = 0;
+    int m_source = 0, m_target = 0;
+
+    std::vector<Cap> m_excess;
+    std::vector<int> m_height;
+    std::vector<int> m_newHeight;
+    std::vector<AtomicExcess<Cap>> m_added;
+    std::vector<std::atomic<bool>> m_queued;
+
+    // active nodes of this round and of the next one
+    std::vector<int> m_active;
+    size_t m_activeSize = 0;
+    std::vector<int> m_next;
+    std::atomic<size_t> m_nextSize = 0;
+
+    std::atomic<size_t> m_cursor = 0;
+    std::atomic<size_t> m_work = 0;
+    int m_step = 0;
+    bool m_done = false;
+
+    std::vector<int> m_queue;
+};
+
+template <class Cap>
+inline BasicParallelPushRelabel<Cap>::BasicParallelPushRelabel(int N, unsigned threads)
+: m_graph(N)
+, m_threads(std::max(1u, threads))
+{
+}
+
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::addEdge(int a, int b, Cap cap) {
+    m_graph.addEdge(a, b, cap);
+}
+
+template <class Cap>
+inline Cap BasicParallelPushRelabel<Cap>::maxFlow(int source, int target) {
+    if (!m_graph.frozen) m_graph.freeze();
+    m_N = m_graph.nodes;
+    m_source = source;
+    m_target = target;
+    m_excess.assign(m_N, 0);
+    m_height.assign(m_N, m_N);
+    m_newHeight.assign(m_N, m_N);
+    std::vector<AtomicExcess<Cap>>(m_N).swap(m_added);
+    std::vector<std::atomic<bool>>(m_N).swap(m_queued);
+    m_active.resize(m_N);
+    m_next.resize(m_N);
+    m_queue.resize(m_N);
+
+    // the preflow of a previous run is not a flow, always start from zero
+    m_graph.clearFlow();
+    for (int arc = m_graph.offset[source]; arc < m_graph.offset[source + 1]; ++ arc) {
+        Cap residue = m_graph.residue[arc];
+        m_graph.residue[arc] = 0;
+        m_graph.residue[m_graph.reverse[arc]] += residue;
+        m_excess[m_graph.to[arc]] += residue;
+    }
+    m_excess[source] = 0;
+
+    globalRelabel();
+    m_step = 0;
+    m_done = m_activeSize == 0;
+
+    if (!m_done) {
+        std::barrier<RoundStep> sync(m_threads, RoundStep{this});
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < m_threads; ++ i) {
+            threads.emplace_back(&BasicParallelPushRelabel::worker, this, std::ref(sync));
+        }
+        worker(sync);
+        for (auto & thread : threads) thread.join();
+    }
+
+    m_excess[target] += m_added[target].take();
+    return m_excess[target];
+}
+
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::worker(std::barrier<RoundStep> & sync) {
+    while (true) {
+        pushNodes();
+        sync.arrive_and_wait();
+        relabelNodes();
+        sync.arrive_and_wait();
+        applyNodes();
+        sync.arrive_and_wait();
+        if (m_done) break;
+    }
+}
+
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::roundStep() noexcept {
+    m_cursor = 0;
+    if (++ m_step % 3 != 0) return;
+
+    // end of the round, the next queue becomes the active one
+    std::swap(m_active, m_next);
+    m_activeSize = m_nextSize;
+    m_nextSize = 0;
+
+    if (m_work > 6 * m_N + m_graph.to.size() / 2) {
+        globalRelabel();
+    }
+    m_done = m_activeSize == 0;
+}
+
+// Discharges active nodes using heights of the previous round. Heights are
+// compared before the residue is read, so a thread never touches an arc pair
+// whose other end is being pushed from.
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::pushNodes() {
+    for (size_t i; (i = m_cursor ++) < m_activeSize; ) {
+        int node = m_active[i];
+        int height = m_height[node];
+        Cap excess = m_excess[node];
+        if (height >= m_N) continue;
+        for (int arc = m_graph.offset[node]; arc < m_graph.offset[node + 1] && excess > 0; ++ arc) {
+            int next = m_graph.to[arc];
+            if (height != m_height[next] + 1 || m_graph.residue[arc] == 0) continue;
+
+            Cap push_by = std::min(excess, m_graph.residue[arc]);
+            m_graph.residue[arc] -= push_by;
+            m_graph.residue[m_graph.reverse[arc]] += push_by;
+            excess -= push_by;
+            m_added[next].add(push_by);
+            if (next != m_target) enqueue(next);
+        }
+        m_excess[node] = excess;
+    }
+}
+
+// Nodes which still have excess have no admissible arc left. The new height is
+// only published by applyNodes, the neighbours may still be reading the old one.
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::relabelNodes() {
+    for (size_t i; (i = m_cursor ++) < m_activeSize; ) {
+        int node = m_active[i];
+        m_newHeight[node] = m_height[node];
+        if (m_excess[node] == 0 || m_height[node] >= m_N) continue;
+
+        int minimum = m_N;
+        for (int arc = m_graph.offset[node]; arc < m_graph.offset[node + 1]; ++ arc) {
+            if (m_graph.residue[arc] > 0) {
+                minimum = std::min(minimum, m_height[m_graph.to[arc]]);
+            }
+        }
+        m_work.fetch_add(m_graph.offset[node + 1] - m_graph.offset[node] + 12, std::memory_order_relaxed);
+        m_newHeight[node] = std::min(minimum + 1, m_N);
+        if (m_newHeight[node] < m_N) enqueue(node);
+    }
+}
+
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::applyNodes() {
+    for (size_t i; (i = m_cursor ++) < m_activeSize + m_nextSize; ) {
+        if (i < m_activeSize) {
+            int node = m_active[i];
+            m_height[node] = m_newHeight[node];
+        } else {
+            int node = m_next[i - m_activeSize];
+            m_excess[node] += m_added[node].take();
+            m_queued[node].store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::enqueue(int node) {
+    if (!m_queued[node].exchange(true, std::memory_order_relaxed)) {
+        m_next[m_nextSize ++] = node;
+    }
+}
+
+// Exact heights by reverse BFS from the target, nodes which cannot reach it
+// are lifted to N. Rebuilds the active queue.
+template <class Cap>
+inline void BasicParallelPushRelabel<Cap>::globalRelabel() {
+    std::fill(m_height.begin(), m_height.end(), m_N);
+    m_work = 0;
+    m_activeSize = 0;
+
+    size_t head = 0, tail = 0;
+    m_queue[tail ++] = m_target;
+    m_height[m_target] = 0;
+    while (head < tail) {
+        int current = m_queue[head ++];
+        if (current != m_target && m_excess[current] > 0) m_active[m_activeSize ++] = current;
+
+        for (int arc = m_graph.offset[current]; arc < m_graph.offset[current + 1]; ++ arc) {
+            int next = m_graph.to[arc];
+            if (next != m_source && m_height[next] == m_N && m_graph.residue[m_graph.reverse[arc]] > 0) {
+                m_height[next] = m_height[current] + 1;
+                m_queue[tail ++] = next;
+            }
+        }
+    }
+}
+
+// Min cut of the last maxFlow, the preflow is left as it is.
+template <class Cap>
+inline MinCut BasicParallelPushRelabel<Cap>::minCut() const {
+    return m_graph.minCut(m_source, m_target, true);
+}
+
+using ParallelPushRelabel = BasicParallelPushRelabel<long>;
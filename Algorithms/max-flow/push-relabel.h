@@ -0,0 +1,311 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "flow-network.h"
+#include "residual-graph.h"
+
+// Highest label push-relabel on the CSR residual graph.
+// Active nodes are kept in buckets by height and the highest one is discharged
+// first, using current arc pointers. Nodes are also linked in per height lists
+// of all nodes, so when relabeling empties a height every node above the gap is
+// lifted to N at once. Heights are recomputed exactly by a reverse BFS from the
+// target at the start and periodically after a batch of relabels.
+// maxFlow runs only the first phase: it stops as soon as no node below N has
+// excess, at that point the excess of the target is the max flow value and
+// the min cut is known, but the preflow is not a flow yet.
+// setCapacity and reoptimize work as in Dinitz. Before the flow is repaired the
+// second phase returns the excess left in the network to the source, by the
+// same discharging towards the source, and reoptimize starts the first phase
+// from the repaired flow.
+template <class Cap>
+class BasicPushRelabel : public BasicFlowNetwork<Cap> {
+    using typename BasicFlowNetwork<Cap>::CapacityChange;
+public:
+    using BasicFlowNetwork<Cap>::INF;
+
+    BasicPushRelabel(int N);
+
+    void addEdge(int a, int b, Cap cap) override;
+    Cap maxFlow(int source, int target) override;
+
+    void setCapacity(int edge, Cap cap);
+    Cap reoptimize(int source, int target);
+
+    MinCut minCut() const;
+
+private:
+
+    void prepare();
+    void applyChanges(int source, int target);
+    Cap preflow(int source, int target);
+    void returnExcess();
+    void dischargeAll(int root, int other);
+    void globalRelabel();
+    void discharge(int node);
+    void push(int node, int arc);
+    void relabel(int node);
+    void activate(int node);
+    void link(int node);
+    void unlink(int node);
+
+    BasicResidualGraph<Cap> m_graph;
+    int m_N = 0;
+    int m_source = -1, m_target = -1;
+    bool m_preflow = false;
+    std::vector<CapacityChange> m_changes;
+
+    // excess is discharged towards the root, the other terminal is never active
+    int m_root = 0, m_other = 0;
+    std::vector<Cap> m_excess;
+    std::vector<int> m_height;
+    std::vector<int> m_current;
+
+    // active nodes by height, singly linked
+    std::vector<int> m_active;
+    std::vector<int> m_nextActive;
+    int m_highestActive = -1;
+
+    // all nodes below N by height, doubly linked
+    std::vector<int> m_bucket;
+    std::vector<int> m_next;
+    std::vector<int> m_prev;
+    int m_highest = -1;
+
+    std::vector<int> m_queue;
+    size_t m_work = 0;
+
+};
+
+template <class Cap>
+inline BasicPushRelabel<Cap>::BasicPushRelabel(int N) : m_graph(N) {}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::addEdge(int a, int b, Cap cap) {
+    m_graph.addEdge(a, b, cap);
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::prepare() {
+    if (!m_graph.frozen) m_graph.freeze();
+    m_N = m_graph.nodes;
+    m_excess.assign(m_N, 0);
+    m_height.assign(m_N, m_N);
+    m_current.assign(m_N, 0);
+    m_active.assign(m_N, -1);
+    m_nextActive.assign(m_N, -1);
+    m_bucket.assign(m_N, -1);
+    m_next.assign(m_N, -1);
+    m_prev.assign(m_N, -1);
+    m_queue.resize(m_N);
+}
+
+template <class Cap>
+inline Cap BasicPushRelabel<Cap>::maxFlow(int source, int target) {
+    prepare();
+    // the preflow of a previous run is not a flow, always start from zero
+    for (const CapacityChange & change : m_changes) {
+        m_graph.setCapacity(change.edge, change.capacity);
+    }
+    m_changes.clear();
+    m_graph.clearFlow();
+    return preflow(source, target);
+}
+
+// First phase, on top of the current flow. Returns how much more reaches the target.
+template <class Cap>
+inline Cap BasicPushRelabel<Cap>::preflow(int source, int target) {
+    m_source = source;
+    m_target = target;
+    std::fill(m_excess.begin(), m_excess.end(), 0);
+    for (int arc = m_graph.offset[source]; arc < m_graph.offset[source + 1]; ++ arc) {
+        Cap residue = m_graph.residue[arc];
+        m_graph.residue[arc] = 0;
+        m_graph.residue[m_graph.reverse[arc]] += residue;
+        m_excess[m_graph.to[arc]] += residue;
+    }
+    m_excess[source] = 0;
+
+    dischargeAll(target, source);
+    m_preflow = true;
+    return m_excess[target];
+}
+
+// Second phase, every node with excess has a residual path back to the source.
+template <class Cap>
+inline void BasicPushRelabel<Cap>::returnExcess() {
+    dischargeAll(m_source, m_target);
+    m_preflow = false;
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::dischargeAll(int root, int other) {
+    m_root = root;
+    m_other = other;
+    globalRelabel();
+    const size_t frequency = 6 * m_N + m_graph.to.size() / 2;
+
+    while (m_highestActive >= 0) {
+        int node = m_active[m_highestActive];
+        if (node == -1) {
+            -- m_highestActive;
+            continue;
+        }
+        m_active[m_highestActive] = m_nextActive[node];
+        discharge(node);
+
+        if (m_work > frequency) {
+            globalRelabel();
+        }
+    }
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::setCapacity(int edge, Cap cap) {
+    m_changes.push_back(CapacityChange{edge, cap});
+}
+
+// Returns the value of the max flow after the capacity changes.
+template <class Cap>
+inline Cap BasicPushRelabel<Cap>::reoptimize(int source, int target) {
+    if (m_preflow) returnExcess();
+    if (!m_graph.frozen || m_N != (int)m_graph.nodes) prepare();
+    applyChanges(source, target);
+
+    preflow(source, target);
+    return m_graph.flowInto(target);
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::applyChanges(int source, int target) {
+    for (const CapacityChange & change : m_changes) {
+        Cap overflow = m_graph.setCapacity(change.edge, change.capacity);
+        if (overflow == 0) continue;
+
+        const auto & edge = m_graph.edges[change.edge];
+        this->repair(edge.from, edge.to, overflow, source, target, [&](int start, int end, Cap limit) {
+            return m_graph.augment(start, end, limit);
+        });
+    }
+    m_changes.clear();
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::globalRelabel() {
+    std::fill(m_height.begin(), m_height.end(), m_N);
+    std::fill(m_active.begin(), m_active.end(), -1);
+    std::fill(m_bucket.begin(), m_bucket.end(), -1);
+    m_highestActive = m_highest = -1;
+    m_work = 0;
+
+    size_t head = 0, tail = 0;
+    m_queue[tail ++] = m_root;
+    m_height[m_root] = 0;
+    while (head < tail) {
+        int current = m_queue[head ++];
+        link(current);
+        if (current != m_root && m_excess[current] > 0) activate(current);
+        m_current[current] = m_graph.offset[current];
+
+        for (int arc = m_graph.offset[current]; arc < m_graph.offset[current + 1]; ++ arc) {
+            int next = m_graph.to[arc];
+            if (next != m_other && m_height[next] == m_N && m_graph.residue[m_graph.reverse[arc]] > 0) {
+                m_height[next] = m_height[current] + 1;
+                m_queue[tail ++] = next;
+            }
+        }
+    }
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::discharge(int node) {
+    while (m_excess[node] > 0) {
+        int end = m_graph.offset[node + 1];
+        for (int & arc = m_current[node]; arc < end; ++ arc) {
+            if (m_graph.residue[arc] > 0 && m_height[node] == m_height[m_graph.to[arc]] + 1) {
+                push(node, arc);
+                if (m_excess[node] == 0) return;
+            }
+        }
+        relabel(node);
+        if (m_height[node] >= m_N) return;
+    }
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::push(int node, int arc) {
+    int next = m_graph.to[arc];
+    Cap push_by = std::min(m_excess[node], m_graph.residue[arc]);
+    m_graph.residue[arc] -= push_by;
+    m_graph.residue[m_graph.reverse[arc]] += push_by;
+    m_excess[node] -= push_by;
+    if (m_excess[next] == 0 && next != m_root && next != m_other) activate(next);
+    m_excess[next] += push_by;
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::relabel(int node) {
+    int height = m_height[node];
+    unlink(node);
+
+    // gap, nothing at or above this height can reach the target any more
+    if (m_bucket[height] == -1) {
+        m_height[node] = m_N;
+        for (int h = height + 1; h <= m_highest; ++ h) {
+            for (int v = m_bucket[h]; v != -1; v = m_next[v]) {
+                m_height[v] = m_N;
+            }
+            m_bucket[h] = -1;
+        }
+        m_highest = height - 1;
+        return;
+    }
+
+    int minimum = m_N;
+    int end = m_graph.offset[node + 1];
+    for (int arc = m_graph.offset[node]; arc < end; ++ arc) {
+        if (m_graph.residue[arc] > 0 && m_height[m_graph.to[arc]] < minimum) {
+            minimum = m_height[m_graph.to[arc]];
+            m_current[node] = arc;
+        }
+    }
+    m_work += end - m_graph.offset[node] + 12;
+
+    m_height[node] = std::min(minimum + 1, m_N);
+    if (m_height[node] < m_N) link(node);
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::activate(int node) {
+    int height = m_height[node];
+    if (height >= m_N) return;
+    m_nextActive[node] = m_active[height];
+    m_active[height] = node;
+    m_highestActive = std::max(m_highestActive, height);
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::link(int node) {
+    int height = m_height[node];
+    m_prev[node] = -1;
+    m_next[node] = m_bucket[height];
+    if (m_bucket[height] != -1) m_prev[m_bucket[height]] = node;
+    m_bucket[height] = node;
+    m_highest = std::max(m_highest, height);
+}
+
+template <class Cap>
+inline void BasicPushRelabel<Cap>::unlink(int node) {
+    if (m_prev[node] != -1) m_next[m_prev[node]] = m_next[node];
+    else m_bucket[m_height[node]] = m_next[node];
+    if (m_next[node] != -1) m_prev[m_next[node]] = m_prev[node];
+}
+
+// Min cut of the last maxFlow or reoptimize, known already after the first phase.
+template <class Cap>
+inline MinCut BasicPushRelabel<Cap>::minCut() const {
+    return m_graph.minCut(m_source, m_target, m_preflow);
+}
+
+using PushRelabel = BasicPushRelabel<long>;
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "flow-network.h"
+#include "flow-decomposition.h"
+
+// Residual graph shared by the push based and the augmenting path networks.
+// Edges are only recorded by addEdge, freeze packs them into compressed sparse
+// rows (CSR): arcs of node v are offset[v] .. offset[v+1]-1 and each arc is
+// stored as struct of arrays (target, residual capacity, index of the reverse
+// arc). Freezing again after more edges were added keeps the flow of the
+// edges packed before.
+template <class Cap>
+struct BasicResidualGraph {
+    struct Edge {
+        int from, to;
+        Cap capacity;
+    };
+
+    explicit BasicResidualGraph(size_t noNodes) : nodes(noNodes) {}
+
+    void addEdge(int a, int b, Cap cap) {
+        edges.push_back(Edge{a, b, cap});
+        frozen = false;
+    }
+
+    void freeze();
+    void clearFlow();
+    Cap setCapacity(int edge, Cap cap);
+    Cap augment(int start, int target, Cap limit);
+    Cap flowInto(int node) const;
+    MinCut minCut(int source, int target, bool fromTarget) const;
+    void gatherFlows(std::vector<Cap> & flows) const;
+
+    int tail(int arc) const { return to[reverse[arc]]; }
+
+    size_t nodes;
+    std::vector<Edge> edges;
+    bool frozen = false;
+
+    std::vector<int> offset;
+    std::vector<int> to;
+    std::vector<Cap> residue;
+    std::vector<int> reverse;
+    std::vector<int> position; // arc of the i-th added edge
+
+    std::vector<int> parent; // scratch of augment
+    std::vector<int> queue;
+};
+
+template <class Cap>
+inline void BasicResidualGraph<Cap>::freeze() {
+    size_t N = nodes;
+    size_t M = edges.size();
+
+    // flow of edges packed by the previous freeze
+    std::vector<Cap> flow(M, 0);
+    for (size_t i = 0; i < position.size(); ++ i) {
+        flow[i] = edges[i].capacity - residue[position[i]];
+    }
+
+    offset.assign(N + 1, 0);
+    for (const Edge & edge : edges) {
+        ++ offset[edge.from + 1];
+        ++ offset[edge.to + 1];
+    }
+    for (size_t v = 0; v < N; ++ v) {
+        offset[v + 1] += offset[v];
+    }
+
+    to.resize(2 * M);
+    residue.resize(2 * M);
+    reverse.resize(2 * M);
+    position.resize(M);
+    std::vector<int> next(offset.begin(), offset.end() - 1);
+    for (size_t i = 0; i < M; ++ i) {
+        const Edge & edge = edges[i];
+        int forward = next[edge.from] ++;
+        int backward = next[edge.to] ++;
+        to[forward] = edge.to;
+        residue[forward] = edge.capacity - flow[i];
+        reverse[forward] = backward;
+        to[backward] = edge.from;
+        residue[backward] = flow[i];
+        reverse[backward] = forward;
+        position[i] = forward;
+    }
+
+    frozen = true;
+}
+
+template <class Cap>
+inline void BasicResidualGraph<Cap>::clearFlow() {
+    for (size_t i = 0; i < edges.size(); ++ i) {
+        residue[position[i]] = edges[i].capacity;
+        residue[reverse[position[i]]] = 0;
+    }
+}
+
+// Returns the flow which does not fit the new capacity. It is taken off the
+// edge, which leaves that much excess at its tail and deficit at its head.
+template <class Cap>
+inline Cap BasicResidualGraph<Cap>::setCapacity(int edge, Cap cap) {
+    Cap old = edges[edge].capacity;
+    edges[edge].capacity = cap;
+    if (edge >= (int)position.size()) return 0; // not packed yet
+
+    int arc = position[edge];
+    Cap flow = old - residue[arc];
+    Cap overflow = std::max(Cap(0), flow - cap);
+    flow -= overflow;
+    residue[arc] = cap - flow;
+    residue[reverse[arc]] = flow;
+    return overflow;
+}
+
+// Sends up to limit units from start to target along shortest residual paths,
+// enough to repair the few imbalances left by setCapacity.
+template <class Cap>
+inline Cap BasicResidualGraph<Cap>::augment(int start, int target, Cap limit) {
+    if (start == target) return limit;
+    parent.resize(nodes);
+    queue.resize(nodes);
+    Cap flow = 0;
+    while (flow < limit) {
+        std::fill(parent.begin(), parent.end(), -1);
+        size_t first = 0, last = 0;
+        queue[last ++] = start;
+        parent[start] = -2;
+        while (first < last && parent[target] == -1) {
+            int current = queue[first ++];
+            for (int arc = offset[current]; arc < offset[current + 1]; ++ arc) {
+                if (residue[arc] > 0 && parent[to[arc]] == -1) {
+                    parent[to[arc]] = arc;
+                    queue[last ++] = to[arc];
+                }
+            }
+        }
+        if (parent[target] == -1) break;
+
+        Cap path_flow = limit - flow;
+        for (int current = target; current != start; current = tail(parent[current])) {
+            path_flow = std::min(path_flow, residue[parent[current]]);
+        }
+        for (int current = target; current != start; current = tail(parent[current])) {
+            residue[parent[current]] -= path_flow;
+            residue[reverse[parent[current]]] += path_flow;
+        }
+        flow += path_flow;
+    }
+    return flow;
+}
+
+template <class Cap>
+inline Cap BasicResidualGraph<Cap>::flowInto(int node) const {
+    Cap flow = 0;
+    for (size_t i = 0; i < position.size(); ++ i) {
+        Cap edgeFlow = residue[reverse[position[i]]];
+        if (edges[i].to == node) flow += edgeFlow;
+        if (edges[i].from == node) flow -= edgeFlow;
+    }
+    return flow;
+}
+
+// Source side of the cut are the nodes reachable from the source in the
+// residual graph. A preflow may leave excess at nodes the source cannot reach,
+// then it has to be the nodes which cannot reach the target instead.
+template <class Cap>
+inline MinCut BasicResidualGraph<Cap>::minCut(int source, int target, bool fromTarget) const {
+    MinCut cut;
+    std::vector<bool> seen(nodes, false);
+    std::vector<int> stack = {fromTarget ? target : source};
+    seen[stack.back()] = true;
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        for (int arc = offset[current]; arc < offset[current + 1]; ++ arc) {
+            int next = to[arc];
+            Cap open = fromTarget ? residue[reverse[arc]] : residue[arc];
+            if (open > 0 && !seen[next]) {
+                seen[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+
+    if (fromTarget) seen.flip();
+    for (size_t i = 0; i < edges.size(); ++ i) {
+        if (seen[edges[i].from] && !seen[edges[i].to]) {
+            cut.edges.push_back(i);
+        }
+    }
+    cut.sourceSide = std::move(seen);
+    return cut;
+}
+
+// Flow of every edge in addEdge order.
+template <class Cap>
+inline void BasicResidualGraph<Cap>::gatherFlows(std::vector<Cap> & flows) const {
+    flows.resize(position.size());
+    for (size_t i = 0; i < position.size(); ++ i) {
+        flows[i] = residue[reverse[position[i]]];
+    }
+}
+
+using ResidualGraph = BasicResidualGraph<long>;
@@ -0,0 +1,338 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+
+#include "cost-flow-network.h"
+#include "cost-scaling.h"
+#include "network-simplex.h"
+#include "../matching/hungarian.h"
+#include "../matching/auction.h"
+
+// Compares the min cost flow engines on random Task Assignment instances:
+// N employees, N tasks and a dense N x N matrix of times 1 .. 1000, solved by
+// primal-dual, cost scaling and the simplex on a flow network and by the
+// Hungarian method and the auction on the matrix. Every flow network holds
+// 2 N^2 edge records of 40 bytes, N = 10000 needs 8 GB, so the default run
+// compares the flow networks up to N = 2000 only; at 5000 and 10000 it runs
+// the matrix solvers alone, and above 5000 only the auction (the Hungarian
+// method takes minutes at 10000).
+// Each N up to 2000 is followed by a transportation instance: N warehouses,
+// 2N shops with demands up to 1000 and a dense matrix of shipping costs.
+// Then an undirected grid of roads, built with undirected edges and with
+// pairs of directed ones, and a sweep which builds the cost curve of the
+// grid by a run per flow limit and by one costCurve.
+// Last a sparse network of 100k nodes, against the memory the dense N x N
+// residue and cost matrices of the former NetworkCostFlow would take.
+// Usage: ./a.out [N ...], sizes given run the flow networks and the
+// transportation instance at any N, for machines with the memory.
+
+std::vector<int> randomCosts(int N, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> time(1, 1000);
+    std::vector<int> costs(N * N);
+    for (int & cost : costs) cost = time(random);
+    return costs;
+}
+
+// The network of the Task Assignment solution, source 0, target 2N+1.
+template <class Network>
+void build(Network & network, int N, const std::vector<int> & costs) {
+    for (int i = 1; i <= N; ++ i) {
+        network.addEdge(0, i, 1, 0);
+        network.addEdge(N + i, 2 * N + 1, 1, 0);
+    }
+    for (int employee = 0; employee < N; ++ employee) {
+        for (int task = 0; task < N; ++ task) {
+            network.addEdge(1 + employee, N + 1 + task, 1, costs[employee * N + task]);
+        }
+    }
+}
+
+template <class Network>
+long run(const std::string & name, int N, const std::vector<int> & costs) {
+    Network network(2 * N + 2);
+    build(network, N, costs);
+
+    auto begin = std::chrono::steady_clock::now();
+    long cost = network.minCostFlow(0, 2 * N + 1, N);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << std::setw(14) << name
+              << std::setw(12) << cost
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count();
+    if constexpr (requires { network.refines(); }) {
+        std::cout << std::setw(10) << network.refines() << std::setw(10) << network.skipped();
+    } else if constexpr (requires { network.pivots(); }) {
+        std::cout << std::setw(10) << network.pivots();
+    } else {
+        std::cout << std::setw(10) << network.phases();
+    }
+    std::cout << "\n";
+    return cost;
+}
+
+// Solvers of the assignment problem on the cost matrix itself.
+template <class Solver>
+long runMatrix(const std::string & name, Solver & solver, const std::vector<int> & costs) {
+    std::copy(costs.begin(), costs.end(), solver.row(0));
+
+    auto begin = std::chrono::steady_clock::now();
+    long cost = solver.solve();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << std::setw(14) << name
+              << std::setw(12) << cost
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count();
+    if constexpr (requires { solver.rounds(); }) {
+        std::cout << std::setw(10) << solver.rounds();
+    }
+    std::cout << "\n";
+    return cost;
+}
+
+// Flow networks only if asked for, the Hungarian algorithm up to N = 5000.
+void compare(int N, bool networks) {
+    auto costs = randomCosts(N, N);
+    std::cout << "N = " << N << " (" << (long)N * N << " edges)\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(12) << "cost" << std::setw(12) << "total ms"
+              << std::setw(10) << "phases" << std::setw(10) << "skipped" << "\n";
+    long expected = -1;
+    auto check = [&](const std::string & name, long cost) {
+        if (expected == -1) expected = cost;
+        if (cost != expected) {
+            std::cerr << name << " gives " << cost << " instead of " << expected << "\n";
+        }
+    };
+    if (networks) {
+        check("primal-dual", run<CostFlowNetwork>("primal-dual", N, costs));
+        check("cost scaling", run<CostScalingNetwork>("cost scaling", N, costs));
+        check("network simplex", run<NetworkSimplex>("simplex", N, costs));
+    }
+    if (N <= 5000) {
+        BasicHungarian<int> hungarian(N, N);
+        check("hungarian", runMatrix("hungarian", hungarian, costs));
+    }
+    for (unsigned threads = 1; threads <= std::max(1u, std::thread::hardware_concurrency()); threads *= 2) {
+        BasicAuction<int> auction(N, threads);
+        check("auction", runMatrix("auction x" + std::to_string(threads), auction, costs));
+    }
+    std::cout << "\n";
+}
+
+struct Transportation {
+    int warehouses, shops;
+    std::vector<long> supply; // negative for the shops
+    std::vector<int> costs;
+};
+
+Transportation randomTransportation(int N, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> cost(1, 1000);
+    std::uniform_int_distribution<long> amount(1, 1000);
+    Transportation instance{N, 2 * N, std::vector<long>(3 * N), std::vector<int>(2 * N * N)};
+    long total = 0;
+    for (int shop = 0; shop < 2 * N; ++ shop) {
+        instance.supply[N + shop] = -amount(random);
+        total -= instance.supply[N + shop];
+    }
+    // the stock is split evenly, exactly what the shops need
+    for (int warehouse = 0; warehouse < N; ++ warehouse) {
+        instance.supply[warehouse] = total / N + (warehouse < total % N);
+    }
+    for (int & c : instance.costs) c = cost(random);
+    return instance;
+}
+
+void compareTransportation(int N) {
+    auto instance = randomTransportation(N, N);
+    int W = instance.warehouses, S = instance.shops;
+    std::cout << "transportation " << W << " x " << S << " (" << (long)W * S << " edges)\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(12) << "cost" << std::setw(12) << "total ms"
+              << std::setw(10) << "phases" << "\n";
+
+    // warehouses 0 .. W-1, shops W .. W+S-1
+    CostFlowNetwork network(W + S + 2);
+    int source = W + S, target = W + S + 1;
+    long stock = 0;
+    NetworkSimplex simplex(W + S);
+    for (int v = 0; v < W + S; ++ v) {
+        long supply = instance.supply[v];
+        if (supply > 0) {
+            network.addEdge(source, v, supply, 0);
+            stock += supply;
+        } else {
+            network.addEdge(v, target, -supply, 0);
+        }
+        simplex.setSupply(v, supply);
+    }
+
+    for (int warehouse = 0; warehouse < W; ++ warehouse) {
+        for (int shop = 0; shop < S; ++ shop) {
+            int cost = instance.costs[warehouse * S + shop];
+            network.addEdge(warehouse, W + shop, NetworkSimplex::INF, cost);
+            simplex.addEdge(warehouse, W + shop, NetworkSimplex::INF, cost);
+        }
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    long expected = network.minCostFlow(source, target, stock);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << "primal-dual" << std::setw(12) << expected
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count()
+              << std::setw(10) << network.phases() << "\n";
+
+    begin = std::chrono::steady_clock::now();
+    simplex.solve();
+    elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << "simplex" << std::setw(12) << simplex.cost()
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count()
+              << std::setw(10) << simplex.pivots() << "\n";
+    if (simplex.cost() != expected) {
+        std::cerr << "network simplex gives " << simplex.cost() << " instead of " << expected << "\n";
+    }
+    std::cout << "\n";
+}
+
+// Random network of `degree` edges out of every node, flowLimit units from
+// the first node to the last one.
+void runSparse(const std::string & name, int N, int degree, long flowLimit) {
+    std::mt19937 random(N);
+    std::uniform_int_distribution<int> node(0, N - 1);
+    std::uniform_int_distribution<long> capacity(1, 10), cost(1, 100);
+    CostFlowNetwork network(N);
+    for (int a = 0; a < N; ++ a) {
+        for (int d = 0; d < degree; ++ d) {
+            network.addEdge(a, node(random), capacity(random), cost(random));
+        }
+    }
+    size_t edges = (size_t)N * degree;
+    // paired edge records and their adjacency entries
+    double bytes = edges * (2 * sizeof(CostFlowNetwork::Edge) + 2 * sizeof(int));
+
+    auto begin = std::chrono::steady_clock::now();
+    long result = network.minCostFlow(0, N - 1, flowLimit);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << std::setw(14) << name
+              << std::setw(12) << result
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count()
+              << std::setw(12) << std::setprecision(1) << bytes / (1 << 20) << "\n";
+}
+
+void compareSparse(int N, int degree, long flowLimit) {
+    std::cout << "sparse " << N << " nodes, " << (long)N * degree << " edges, flow " << flowLimit << "\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(12) << "cost" << std::setw(12) << "total ms"
+              << std::setw(12) << "edges MB" << "\n";
+    // residue and cost matrices, a set entry and two adjacency entries per edge
+    double dense = 2.0 * N * N * sizeof(long) + (double)N * degree * (48 + 2 * sizeof(int));
+    std::cout << std::setw(14) << "dense spfa" << std::setw(36) << std::fixed << std::setprecision(1) << dense / (1 << 20) << "\n";
+    runSparse("primal-dual", N, degree, flowLimit);
+    std::cout << "\n";
+}
+
+// Side x side grid of roads with capacities 10 .. 20.
+void buildGrid(CostFlowNetwork & network, int side, bool undirected) {
+    std::mt19937 random(side);
+    std::uniform_int_distribution<long> capacity(10, 20), cost(1, 100);
+    auto road = [&](int a, int b) {
+        long cap = capacity(random), price = cost(random);
+        if (undirected) {
+            network.addUndirectedEdge(a, b, cap, price);
+        } else {
+            network.addEdge(a, b, cap, price);
+            network.addEdge(b, a, cap, price);
+        }
+    };
+    for (int y = 0; y < side; ++ y) {
+        for (int x = 0; x < side; ++ x) {
+            if (x + 1 < side) road(y * side + x, y * side + x + 1);
+            if (y + 1 < side) road(y * side + x, (y + 1) * side + x);
+        }
+    }
+}
+
+// `flowLimit` units from one corner of the grid to the opposite one.
+void runGrid(const std::string & name, int side, long flowLimit, bool undirected) {
+    CostFlowNetwork network(side * side);
+    buildGrid(network, side, undirected);
+
+    auto begin = std::chrono::steady_clock::now();
+    long result = network.minCostFlow(0, side * side - 1, flowLimit);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << std::setw(14) << name
+              << std::setw(12) << result
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count()
+              << std::setw(10) << network.phases()
+              << std::setw(12) << std::setprecision(1) << network.arcs().size() * sizeof(CostFlowNetwork::Edge) / double(1 << 20) << "\n";
+}
+
+void compareGrid(int side, long flowLimit) {
+    std::cout << "grid " << side << " x " << side << ", flow " << flowLimit << "\n";
+    std::cout << std::setw(14) << "edges" << std::setw(12) << "cost" << std::setw(12) << "total ms"
+              << std::setw(10) << "phases" << std::setw(12) << "edges MB" << "\n";
+    runGrid("directed", side, flowLimit, false);
+    runGrid("undirected", side, flowLimit, true);
+    std::cout << "\n";
+}
+
+// Cost curve of the grid corner to corner at the flows 1 .. steps: a new
+// network for every limit against one curve.
+void compareSweep(int side, long steps) {
+    std::cout << "sweep " << side << " x " << side << ", flows 1 .. " << steps << "\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(12) << "cost" << std::setw(12) << "total ms" << "\n";
+    int target = side * side - 1;
+
+    auto begin = std::chrono::steady_clock::now();
+    long total = 0;
+    for (long flow = 1; flow <= steps; ++ flow) {
+        CostFlowNetwork network(side * side);
+        buildGrid(network, side, true);
+        total += network.minCostFlow(0, target, flow);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << "min cost flow" << std::setw(12) << total
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count() << "\n";
+
+    begin = std::chrono::steady_clock::now();
+    CostFlowNetwork network(side * side);
+    buildGrid(network, side, true);
+    auto curve = network.costCurve(0, target, steps);
+    // the cost is linear between the breakpoints
+    total = 0;
+    size_t i = 0;
+    for (long flow = 1; flow <= steps; ++ flow) {
+        while (curve[i + 1].flow < flow) ++ i;
+        const auto & a = curve[i], & b = curve[i + 1];
+        total += a.cost + (flow - a.flow) * (b.cost - a.cost) / (b.flow - a.flow);
+    }
+    elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << "cost curve" << std::setw(12) << total
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count() << "\n\n";
+}
+
+int main (int argc, char * argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++ i) {
+            int N = std::atoi(argv[i]);
+            compare(N, true);
+            compareTransportation(N);
+        }
+        return 0;
+    }
+    for (int N : {200, 500, 1000, 2000}) {
+        compare(N, true);
+        compareTransportation(N);
+    }
+    compare(5000, false);
+    compare(10000, false);
+    compareGrid(500, 20);
+    compareSweep(200, 20);
+    compareSparse(100000, 4, 10);
+}
@@ -0,0 +1,269 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <tuple>
+#include <cstdlib>
+
+#include "cost-flow-network.h"
+#include "network-simplex.h"
+
+void testChat() {
+    CostFlowNetwork g(6);
+    g.addEdge(0, 1, 10, 2);
+    g.addEdge(0, 2, 5, 6);
+    g.addEdge(1, 2, 15, 1);
+    g.addEdge(1, 3, 10, 4);
+    g.addEdge(2, 4, 10, 2);
+    g.addEdge(3, 4, 10, 3);
+    g.addEdge(3, 5, 10, 1);
+    g.addEdge(4, 5, 10, 2);
+
+    auto cost = g.minCostFlow(0, 5, 15);
+    std::cout << cost << "\n";
+    assert(cost == 120);
+}
+
+// https://www.spoj.com/problems/GREED/, exchanges go both ways
+void GREED_Greedy_island () {
+    CostFlowNetwork network(6);
+    network.addEdge(0, 1, 1, 0);
+    network.addEdge(0, 2, 3, 0);
+
+    network.addUndirectedEdge(2, 3, CostFlowNetwork::INF, 1);
+    network.addUndirectedEdge(3, 4, CostFlowNetwork::INF, 1);
+
+    network.addEdge(1, 5, 1, 0);
+    network.addEdge(2, 5, 1, 0);
+    network.addEdge(3, 5, 1, 0);
+    network.addEdge(4, 5, 1, 0);
+
+    auto cost = network.minCostFlow(0, 5, 4);
+    assert(cost == 3);
+}
+
+void testDecomposition() {
+    CostFlowNetwork g(6);
+    g.addEdge(0, 1, 10, 2);
+    g.addEdge(0, 2, 5, 6);
+    g.addEdge(1, 2, 15, 1);
+    g.addEdge(1, 3, 10, 4);
+    g.addEdge(2, 4, 10, 2);
+    g.addEdge(3, 4, 10, 3);
+    g.addEdge(3, 5, 10, 1);
+    g.addEdge(4, 5, 10, 2);
+    auto cost = g.minCostFlow(0, 5, 15);
+
+    auto flows = g.flows();
+    auto edges = g.edges();
+    std::vector<long> sum(flows.size(), 0);
+    long total = 0, pathCost = 0;
+    for (const auto & path : g.decompose()) {
+        assert(!path.cycle);
+        assert(edges[path.edges.front()].from == 0 && edges[path.edges.back()].to == 5);
+        total += path.flow;
+        for (int edge : path.edges) {
+            sum[edge] += path.flow;
+            pathCost += path.flow * edges[edge].cost;
+        }
+    }
+    assert(total == 15);
+    assert(pathCost == cost);
+    for (size_t i = 0; i < flows.size(); ++ i) {
+        assert(sum[i] == flows[i]);
+    }
+}
+
+// Successive shortest paths by Bellman-Ford, one path at a time, to compare with.
+long simpleMinCostFlow(int N, const std::vector<std::tuple<int, int, long, long>> & edges, int source, int target, long flowLimit) {
+    struct Arc { int to; long residue, cost; };
+    std::vector<Arc> arcs;
+    std::vector<std::vector<int>> adjacent(N);
+    for (auto [a, b, cap, cost] : edges) {
+        adjacent[a].push_back(arcs.size());
+        arcs.push_back({b, cap, cost});
+        adjacent[b].push_back(arcs.size());
+        arcs.push_back({a, 0, -cost});
+    }
+    long flow = 0, cost = 0;
+    while (flow < flowLimit) {
+        std::vector<long> distance(N, CostFlowNetwork::INF);
+        std::vector<int> parent(N, -1);
+        distance[source] = 0;
+        for (int round = 0; round < N; ++ round) {
+            for (int v = 0; v < N; ++ v) {
+                if (distance[v] == CostFlowNetwork::INF) continue;
+                for (int idx : adjacent[v]) {
+                    if (arcs[idx].residue > 0 && distance[arcs[idx].to] > distance[v] + arcs[idx].cost) {
+                        distance[arcs[idx].to] = distance[v] + arcs[idx].cost;
+                        parent[arcs[idx].to] = idx;
+                    }
+                }
+            }
+        }
+        if (distance[target] == CostFlowNetwork::INF) break;
+        long path = flowLimit - flow;
+        for (int v = target; v != source; v = arcs[parent[v] ^ 1].to) path = std::min(path, arcs[parent[v]].residue);
+        for (int v = target; v != source; v = arcs[parent[v] ^ 1].to) {
+            arcs[parent[v]].residue -= path;
+            arcs[parent[v] ^ 1].residue += path;
+        }
+        flow += path;
+        cost += path * distance[target];
+    }
+    return flow < flowLimit ? -1 : cost;
+}
+
+// The cheaper of two parallel edges fills up first, the counter edge is
+// a different edge and does not cancel anything.
+void testParallelEdges() {
+    CostFlowNetwork g(3);
+    g.addEdge(0, 1, 2, 5);
+    g.addEdge(0, 1, 3, 1);
+    g.addEdge(1, 0, 4, 1);
+    g.addEdge(1, 2, 10, 0);
+
+    assert(g.minCostFlow(0, 2, 4) == 3 * 1 + 1 * 5);
+    auto flows = g.flows();
+    assert(flows[0] == 1 && flows[1] == 3 && flows[2] == 0);
+}
+
+void testRandom() {
+    std::mt19937 random(9);
+    for (int round = 0; round < 500; ++ round) {
+        int N = 2 + random() % 12, M = random() % 40;
+        std::vector<std::tuple<int, int, long, long>> edges;
+        for (int i = 0; i < M; ++ i) {
+            int a = random() % N, b = random() % N;
+            if (a == b || b == 0) continue;
+            // negative costs only out of the source, which is on no cycle
+            long cost = (long)(random() % 20) - (a == 0 ? 10 : 0);
+            edges.push_back({a, b, random() % 10, cost});
+        }
+        long flowLimit = random() % 25;
+        CostFlowNetwork network(N);
+        for (auto [a, b, cap, cost] : edges) network.addEdge(a, b, cap, cost);
+        assert(network.minCostFlow(0, N - 1, flowLimit) == simpleMinCostFlow(N, edges, 0, N - 1, flowLimit));
+    }
+}
+
+// An undirected edge costs the same as the two directed ones, its flow is
+// signed and paths of the decomposition go along it either way.
+void testUndirected() {
+    std::mt19937 random(4);
+    for (int round = 0; round < 500; ++ round) {
+        int N = 2 + random() % 12, M = random() % 30;
+        std::vector<std::tuple<int, int, long, long>> edges, directed;
+        CostFlowNetwork network(N);
+        for (int i = 0; i < M; ++ i) {
+            int a = random() % N, b = random() % N;
+            long cap = random() % 10, cost = random() % 20;
+            edges.push_back({a, b, cap, cost});
+            directed.push_back({a, b, cap, cost});
+            directed.push_back({b, a, cap, cost});
+            network.addUndirectedEdge(a, b, cap, cost);
+        }
+        long flowLimit = random() % 25;
+        long cost = network.minCostFlow(0, N - 1, flowLimit);
+        assert(cost == simpleMinCostFlow(N, directed, 0, N - 1, flowLimit));
+        if (cost == -1) continue;
+
+        auto flows = network.flows();
+        long edgesCost = 0;
+        for (int i = 0; i < M; ++ i) {
+            assert(std::abs(flows[i]) <= std::get<2>(edges[i]));
+            edgesCost += std::abs(flows[i]) * std::get<3>(edges[i]);
+        }
+        assert(edgesCost == cost);
+
+        long total = 0;
+        for (const auto & path : network.decompose()) {
+            if (!path.cycle) total += path.flow;
+        }
+        assert(total == flowLimit);
+    }
+}
+
+// Negative costs anywhere, the cycles are cancelled first. Network simplex
+// saturates them as well.
+void testNegativeCycles() {
+    std::mt19937 random(6);
+    for (int round = 0; round < 1000; ++ round) {
+        int N = 2 + random() % 12, M = random() % 40;
+        CostFlowNetwork network(N);
+        NetworkSimplex simplex(N);
+        for (int i = 0; i < M; ++ i) {
+            int a = random() % N, b = random() % N;
+            long cap = random() % 10, cost = (long)(random() % 30) - 15;
+            network.addEdge(a, b, cap, cost);
+            simplex.addEdge(a, b, cap, cost);
+        }
+        long flowLimit = random() % 15;
+        assert(network.minCostFlow(0, N - 1, flowLimit) == simplex.minCostFlow(0, N - 1, flowLimit));
+    }
+}
+
+// The curve of one run matches a separate run for every flow up to the max
+// flow, also when it is built by a sweep of growing limits.
+void testCostCurve() {
+    std::mt19937 random(2);
+    for (int round = 0; round < 300; ++ round) {
+        int N = 2 + random() % 10, M = random() % 30;
+        std::vector<std::tuple<int, int, long, long>> edges;
+        for (int i = 0; i < M; ++ i) {
+            int a = random() % N, b = random() % N;
+            if (a == b) continue;
+            edges.push_back({a, b, random() % 10, random() % 20});
+        }
+        CostFlowNetwork network(N), sweep(N);
+        for (auto [a, b, cap, cost] : edges) {
+            network.addEdge(a, b, cap, cost);
+            sweep.addEdge(a, b, cap, cost);
+        }
+        auto curve = network.costCurve(0, N - 1, CostFlowNetwork::INF);
+        assert(curve.front().flow == 0 && curve.front().cost == 0);
+
+        long maxFlow = curve.back().flow;
+        for (long flow = 0, i = 0; flow <= maxFlow + 1; ++ flow) {
+            while (i + 1 < (long)curve.size() && curve[i + 1].flow < flow) ++ i;
+            long expected = simpleMinCostFlow(N, edges, 0, N - 1, flow);
+            if (flow > maxFlow) {
+                assert(expected == -1);
+                continue;
+            }
+            long cost = curve[i].cost;
+            if (flow > curve[i].flow) {
+                const auto & a = curve[i], & b = curve[i + 1];
+                assert((flow - a.flow) * (b.cost - a.cost) % (b.flow - a.flow) == 0);
+                cost = a.cost + (flow - a.flow) * (b.cost - a.cost) / (b.flow - a.flow);
+            }
+            assert(cost == expected);
+        }
+
+        // slopes grow, a sweep ends with the same breakpoints
+        for (size_t i = 2; i < curve.size(); ++ i) {
+            assert((curve[i].cost - curve[i - 1].cost) * (curve[i - 1].flow - curve[i - 2].flow)
+                   > (curve[i - 1].cost - curve[i - 2].cost) * (curve[i].flow - curve[i - 1].flow));
+        }
+        std::span<const CostFlowNetwork::CurvePoint> swept;
+        for (long limit = 0; limit <= maxFlow + 3; limit += 1 + random() % 3) {
+            swept = sweep.costCurve(0, N - 1, limit);
+            assert(swept.back().flow == std::min(limit, maxFlow));
+        }
+        assert(swept.size() == curve.size());
+        for (size_t i = 0; i < curve.size(); ++ i) {
+            assert(swept[i].flow == curve[i].flow && swept[i].cost == curve[i].cost);
+        }
+    }
+}
+
+int main () {
+    testChat();
+    GREED_Greedy_island();
+    testDecomposition();
+    testParallelEdges();
+    testRandom();
+    testUndirected();
+    testNegativeCycles();
+    testCostCurve();
+}
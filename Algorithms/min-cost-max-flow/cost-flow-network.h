@@ -0,0 +1,384 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <span>
+#include <algorithm>
+
+#include "radix-heap.h"
+#include "../max-flow/flow-decomposition.h"
+
+// Min cost flow on a paired edge list: edge i of addEdge is stored at 2i and
+// its reverse (no capacity, negated cost) at 2i+1, so the reverse of an edge
+// is idx ^ 1. arcs() is that paired list, edges(), flows() and decompose()
+// number the edges in addEdge order. Parallel edges and edges in both
+// directions are fine, negative costs and negative cycles too; a negative
+// cycle needs a finite capacity.
+// An undirected edge takes a single pair as well, its two directions are each
+// other's reverse with the same capacity and cost. Its flow is signed, flow
+// against it first cancels at -cost, then it costs cost again, so the cost
+// must not be negative.
+// Primal-dual successive shortest paths: one SPFA which cancels the negative
+// cycles gives node potentials, after that all reduced costs (cost + p[from] - p[to]) of
+// residual edges are non-negative and shortest paths are found by Dijkstra on
+// a radix heap. Dijkstra stops at the target, its distances (capped at the
+// target's one) are added to the potentials, which makes every edge on a
+// shortest path of zero reduced cost. All the shortest paths are then
+// augmented at once by a Dinitz blocking flow on the zero reduced cost edges,
+// each of them costs p[target] - p[source] per unit.
+// That cost only grows from one Dijkstra to the next, so the min cost of a
+// flow is a convex piecewise linear function of it and costCurve gets all its
+// breakpoints in one run.
+class CostFlowNetwork {
+    public:
+        CostFlowNetwork(size_t noNodes);
+        void addEdge(int a, int b, long cap, long cost);
+        void addUndirectedEdge(int a, int b, long cap, long cost);
+        long minCostFlow(int source, int target, long flowLimit);
+
+        struct CurvePoint {
+            long flow, cost;
+        };
+        std::span<const CurvePoint> costCurve(int source, int target, long flowLimit);
+        size_t phases() const { return m_phases; }
+
+        struct Edge {
+            int from, to;
+            long capacity, flow = 0, cost;
+            Edge (int a, int b, long capacity, long cost)
+            : from(a), to(b), capacity(capacity), cost(cost) {
+            }
+
+            // a direction of an undirected edge with flow the other way
+            // offers only that flow for cancelling
+            long residue() const {
+                return flow < 0 && capacity > 0 ? -flow : capacity - flow;
+            }
+
+            long unitCost() const {
+                return flow < 0 && capacity > 0 ? -cost : cost;
+            }
+        };
+
+        // all arcs of the paired list, the reverse ones included, see above
+        std::span<const Edge> arcs() const { return m_edges; }
+        std::vector<Edge> edges() const;
+        std::vector<long> flows() const;
+        std::vector<FlowPath> decompose() const;
+
+        inline static long INF = 1e18;
+
+    private:
+        long initPotentials();
+        int findCycle(const std::vector<int> & parent) const;
+        long cancelCycle(int node, const std::vector<int> & parent);
+        bool dijkstra(int source, int target);
+        bool levels(int source, int target);
+        long blockingFlow(int source, int target, long limit);
+
+        long reduced(const Edge & edge) const {
+            return edge.unitCost() + m_potential[edge.from] - m_potential[edge.to];
+        }
+
+        std::vector<std::vector<int>> m_adjacent;
+        std::vector<Edge> m_edges;
+        int m_source = 0, m_target = 0;
+        std::vector<CurvePoint> m_curve;
+
+        std::vector<long> m_potential;
+        std::vector<long> m_distance;
+        RadixHeap<int> m_heap;
+        // blocking flow on the zero reduced cost edges
+        std::vector<int> m_level;
+        std::vector<size_t> m_current;
+        std::vector<int> m_queue;
+        std::vector<int> m_path;
+        size_t m_phases = 0;
+};
+
+inline CostFlowNetwork::CostFlowNetwork(size_t noNodes)
+: m_adjacent(noNodes){
+}
+
+inline void CostFlowNetwork::addEdge(int a, int b, long cap, long cost) {
+    m_curve.clear();
+    auto m = m_edges.size();
+    m_edges.emplace_back(Edge{a, b, cap, cost});
+    m_adjacent[a].push_back(m ++);
+    m_edges.emplace_back(Edge{b, a, 0, -cost});
+    m_adjacent[b].push_back(m);
+}
+
+inline void CostFlowNetwork::addUndirectedEdge(int a, int b, long cap, long cost) {
+    m_curve.clear();
+    auto m = m_edges.size();
+    m_edges.emplace_back(Edge{a, b, cap, cost});
+    m_adjacent[a].push_back(m ++);
+    m_edges.emplace_back(Edge{b, a, cap, cost});
+    m_adjacent[b].push_back(m);
+}
+
+// Returns the cost of flowLimit units together with the negative cycles, -1
+// if that much does not fit.
+inline long CostFlowNetwork::minCostFlow(int source, int target, long flowLimit) {
+    m_curve.clear();
+    const CurvePoint & last = costCurve(source, target, flowLimit).back();
+    if (last.flow < flowLimit) return -1;
+    return last.cost;
+}
+
+// Breakpoints of the min cost as a function of the flow up to flowLimit or the
+// max flow, the first one is the flow 0 at the cost of the negative cycles.
+// The cost is linear between two breakpoints. Another call for the same
+// source and target goes on from the flow of the last one, so a sweep over
+// growing limits costs one run. A new edge starts a new curve on top of the
+// flow sent so far.
+inline std::span<const CostFlowNetwork::CurvePoint> CostFlowNetwork::costCurve(int source, int target, long flowLimit) {
+    if (m_curve.empty() || source != m_source || target != m_target) {
+        m_source = source;
+        m_target = target;
+        size_t N = m_adjacent.size();
+        m_distance.resize(N);
+        m_level.resize(N);
+        m_current.resize(N);
+        m_queue.resize(N);
+        m_curve.assign(1, CurvePoint{0, initPotentials()});
+    }
+
+    long flow = m_curve.back().flow;
+    long cost = m_curve.back().cost;
+    while (flow < flowLimit && dijkstra(source, target)) {
+        ++ m_phases;
+        long pathCost = m_potential[target] - m_potential[source];
+        while (flow < flowLimit && levels(source, target)) {
+            long pathFlow = blockingFlow(source, target, flowLimit - flow);
+            flow += pathFlow;
+            cost += pathFlow * pathCost;
+        }
+
+        // a phase cut short by the last limit goes on at the same slope
+        size_t n = m_curve.size();
+        if (n >= 2) {
+            const CurvePoint & a = m_curve[n - 2], & b = m_curve[n - 1];
+            if ((b.cost - a.cost) == pathCost * (b.flow - a.flow)) m_curve.pop_back();
+        }
+        m_curve.push_back(CurvePoint{flow, cost});
+    }
+    return m_curve;
+}
+
+// Shortest distances from a virtual root with an edge of cost 0 to every
+// node by SPFA, costs may be negative. Every N relaxations the edges the
+// distances came through are checked for a cycle; such a cycle is negative,
+// the flow which fits is sent around it and the search goes on from all
+// nodes. Returns the cost of the cancelled cycles.
+inline long CostFlowNetwork::initPotentials() {
+    size_t N = m_adjacent.size();
+    m_potential.assign(N, 0);
+    std::vector<int> parent(N, -1);
+    std::vector<bool> inQ(N, true);
+    std::deque<int> q;
+    for (size_t v = 0; v < N; ++ v) q.push_back(v);
+    long cost = 0;
+    size_t relaxed = 0;
+    while (!q.empty()) {
+        auto current = q.front();
+        q.pop_front();
+        inQ[current] = false;
+
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_potential[edge.to] > m_potential[current] + edge.unitCost()) {
+                m_potential[edge.to] = m_potential[current] + edge.unitCost();
+                parent[edge.to] = idx;
+                if (!inQ[edge.to]) {
+                    inQ[edge.to] = true;
+                    q.push_back(edge.to);
+                }
+                if (++ relaxed % N != 0) continue;
+
+                int node = findCycle(parent);
+                if (node == -1) continue;
+                cost += cancelCycle(node, parent);
+                std::fill(parent.begin(), parent.end(), -1);
+                for (size_t v = 0; v < N; ++ v) {
+                    if (!inQ[v]) q.push_back(v);
+                }
+                std::fill(inQ.begin(), inQ.end(), true);
+                break;
+            }
+        }
+    }
+    return cost;
+}
+
+// A node on a cycle of parent edges, -1 if there is none.
+inline int CostFlowNetwork::findCycle(const std::vector<int> & parent) const {
+    size_t N = m_adjacent.size();
+    std::vector<int> walk(N, -1);
+    for (size_t start = 0; start < N; ++ start) {
+        int node = start;
+        while (node != -1 && walk[node] == -1) {
+            walk[node] = start;
+            node = parent[node] == -1 ? -1 : m_edges[parent[node]].from;
+        }
+        if (node != -1 && walk[node] == (int)start) return node;
+    }
+    return -1;
+}
+
+// Sends the bottleneck around the cycle of parent edges through the node,
+// returns its cost.
+inline long CostFlowNetwork::cancelCycle(int node, const std::vector<int> & parent) {
+    long bottleneck = INF, unitCost = 0;
+    int current = node;
+    do {
+        const Edge & edge = m_edges[parent[current]];
+        bottleneck = std::min(bottleneck, edge.residue());
+        unitCost += edge.unitCost();
+        current = edge.from;
+    } while (current != node);
+    do {
+        int idx = parent[current];
+        m_edges[idx].flow += bottleneck;
+        m_edges[idx ^ 1].flow -= bottleneck;
+        current = m_edges[idx].from;
+    } while (current != node);
+    return bottleneck * unitCost;
+}
+
+// Dijkstra by reduced costs, then moves the potentials by the distances.
+inline bool CostFlowNetwork::dijkstra(int source, int target) {
+    std::fill(m_distance.begin(), m_distance.end(), INF);
+    m_heap.clear();
+    m_distance[source] = 0;
+    m_heap.push(0, source);
+    while (!m_heap.empty()) {
+        auto [distance, current] = m_heap.pop();
+        if ((long)distance != m_distance[current]) continue;
+        if (current == target) break;
+
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_distance[edge.to] > m_distance[current] + reduced(edge)) {
+                m_distance[edge.to] = m_distance[current] + reduced(edge);
+                m_heap.push(m_distance[edge.to], edge.to);
+            }
+        }
+    }
+    if (m_distance[target] == INF) return false;
+
+    // nodes not settled before the target keep their reduced costs non-negative
+    for (size_t v = 0; v < m_adjacent.size(); ++ v) {
+        m_potential[v] += std::min(m_distance[v], m_distance[target]);
+    }
+    return true;
+}
+
+// BFS levels over residual edges of zero reduced cost.
+inline bool CostFlowNetwork::levels(int source, int target) {
+    std::fill(m_level.begin(), m_level.end(), -1);
+    size_t head = 0, tail = 0;
+    m_queue[tail ++] = source;
+    m_level[source] = 0;
+    while (head < tail && m_level[target] == -1) {
+        int current = m_queue[head ++];
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_level[edge.to] == -1 && reduced(edge) == 0) {
+                m_level[edge.to] = m_level[current] + 1;
+                m_queue[tail ++] = edge.to;
+            }
+        }
+    }
+    return m_level[target] != -1;
+}
+
+// Iterative DFS as in Dinitz, edges on the path stack, dead ends leave the levels.
+inline long CostFlowNetwork::blockingFlow(int source, int target, long limit) {
+    std::fill(m_current.begin(), m_current.end(), 0);
+    m_path.clear();
+    long flow = 0;
+    int node = source;
+
+    while (flow < limit) {
+        if (node == target) {
+            long path_flow = limit - flow;
+            for (int idx : m_path) {
+                path_flow = std::min(path_flow, m_edges[idx].residue());
+            }
+            size_t saturated = m_path.size();
+            for (size_t i = 0; i < m_path.size(); ++ i) {
+                int idx = m_path[i];
+                m_edges[idx].flow += path_flow;
+                m_edges[idx ^ 1].flow -= path_flow;
+                // cancelling all the flow of an undirected edge turns it around
+                // at a positive reduced cost, then it is no longer on the level graph
+                bool blocked = m_edges[idx].residue() == 0 || reduced(m_edges[idx]) != 0;
+                if (blocked && saturated == m_path.size()) saturated = i;
+            }
+            flow += path_flow;
+            // continue from the tail of the first saturated edge
+            m_path.resize(saturated);
+            node = m_path.empty() ? source : m_edges[m_path.back()].to;
+            continue;
+        }
+
+        // advance
+        const std::vector<int> & adjacent = m_adjacent[node];
+        size_t & i = m_current[node];
+        while (i < adjacent.size()) {
+            const Edge & edge = m_edges[adjacent[i]];
+            if (edge.residue() > 0 && m_level[edge.to] == m_level[node] + 1 && reduced(edge) == 0) break;
+            ++ i;
+        }
+        if (i < adjacent.size()) {
+            m_path.push_back(adjacent[i]);
+            node = m_edges[adjacent[i]].to;
+            continue;
+        }
+
+        // retreat
+        if (node == source) break;
+        m_level[node] = -1;
+        m_path.pop_back();
+        node = m_path.empty() ? source : m_edges[m_path.back()].to;
+        ++ m_current[node];
+    }
+
+    return flow;
+}
+
+// Every edge in addEdge order, the same numbering as flows and decompose.
+inline std::vector<CostFlowNetwork::Edge> CostFlowNetwork::edges() const {
+    std::vector<Edge> edges;
+    edges.reserve(m_edges.size() / 2);
+    for (size_t i = 0; i < m_edges.size(); i += 2) edges.push_back(m_edges[i]);
+    return edges;
+}
+
+// Flow of every edge in addEdge order, the flow of an undirected edge is
+// negative when it goes from b to a.
+inline std::vector<long> CostFlowNetwork::flows() const {
+    std::vector<long> flows(m_edges.size() / 2);
+    for (size_t i = 0; i < flows.size(); ++ i) {
+        flows[i] = m_edges[2 * i].flow;
+    }
+    return flows;
+}
+
+// Paths from the source to the target and cycles of the last minCostFlow,
+// edges in addEdge order.
+inline std::vector<FlowPath> CostFlowNetwork::decompose() const {
+    // reverse edges get no flow, so they are skipped, an undirected edge has
+    // it in one of its directions
+    std::vector<long> flow(m_edges.size(), 0);
+    for (size_t i = 0; i < m_edges.size(); ++ i) {
+        flow[i] = std::max(0L, m_edges[i].flow);
+    }
+    auto paths = decomposeFlow(m_adjacent.size(), m_source, m_target, arcs(), std::move(flow));
+    for (auto & path : paths) {
+        for (int & edge : path.edges) edge /= 2;
+    }
+    return paths;
+}
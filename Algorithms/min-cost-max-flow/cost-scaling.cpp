@@ -0,0 +1,60 @@
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "cost-scaling.h"
+#include "cost-flow-network.h"
+
+void testChat() {
+    CostScalingNetwork g(6);
+    g.addEdge(0, 1, 10, 2);
+    g.addEdge(0, 2, 5, 6);
+    g.addEdge(1, 2, 15, 1);
+    g.addEdge(1, 3, 10, 4);
+    g.addEdge(2, 4, 10, 2);
+    g.addEdge(3, 4, 10, 3);
+    g.addEdge(3, 5, 10, 1);
+    g.addEdge(4, 5, 10, 2);
+
+    assert(g.minCostFlow(0, 5, 15) == 120);
+    // more than the max flow
+    assert(g.minCostFlow(0, 5, 21) == -1);
+    assert(g.minCostFlow(0, 5, 15) == 120);
+}
+
+// Same costs as the successive shortest paths of CostFlowNetwork.
+void testRandom() {
+    std::mt19937 random(11);
+    for (int round = 0; round < 500; ++ round) {
+        int N = 2 + random() % 15, M = random() % 50;
+        CostScalingNetwork scaling(N);
+        CostFlowNetwork network(N);
+        for (int i = 0; i < M; ++ i) {
+            int a = random() % N, b = random() % N;
+            long cap = random() % 10, cost = random() % 20;
+            scaling.addEdge(a, b, cap, cost);
+            network.addEdge(a, b, cap, cost);
+        }
+        long flowLimit = random() % 25;
+        long cost = scaling.minCostFlow(0, N - 1, flowLimit);
+        assert(cost == network.minCostFlow(0, N - 1, flowLimit));
+
+        if (cost == -1) continue;
+        long total = 0, edgesCost = 0;
+        auto flows = scaling.flows();
+        auto edges = scaling.edges();
+        for (size_t i = 0; i < flows.size(); ++ i) {
+            assert(flows[i] >= 0 && flows[i] <= edges[i].capacity);
+            if (edges[i].from == 0) total += flows[i];
+            if (edges[i].to == 0) total -= flows[i];
+            edgesCost += flows[i] * edges[i].cost;
+        }
+        assert(total == flowLimit);
+        assert(edgesCost == cost);
+    }
+}
+
+int main () {
+    testChat();
+    testRandom();
+}
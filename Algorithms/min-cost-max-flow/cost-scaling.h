@@ -0,0 +1,234 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+
+// Min cost flow by cost scaling (Goldberg-Tarjan), with the addEdge API and
+// the paired edge list of CostFlowNetwork: edge i of addEdge is stored at 2i,
+// its reverse at 2i+1. Costs are multiplied by N + 1, then a flow which is
+// epsilon-optimal for epsilon 1 (every residual edge has reduced cost
+// cost + p[from] - p[to] of at least -1) is optimal. Each refine divides
+// epsilon by 4, saturates the edges of negative reduced cost and pushes the
+// excess along them (FIFO push-relabel, a relabel lowers the price of the
+// node until an edge gets negative). Before a refine a few rounds of
+// Bellman-Ford try to find prices which make the current flow
+// epsilon-optimal already (price refinement), then the refine is skipped.
+// The flow of flowLimit units is a supply at the source and a demand at the
+// target, an extra edge between them of prohibitive cost keeps it feasible;
+// if the extra edge is used in the end the limit does not fit.
+class CostScalingNetwork {
+    public:
+        CostScalingNetwork(size_t noNodes);
+        void addEdge(int a, int b, long cap, long cost);
+        long minCostFlow(int source, int target, long flowLimit);
+
+        size_t refines() const { return m_refines; }
+        size_t skipped() const { return m_skipped; }
+
+        struct Edge {
+            int from, to;
+            long capacity, flow = 0, cost;
+            Edge (int a, int b, long capacity, long cost)
+            : from(a), to(b), capacity(capacity), cost(cost) {
+            }
+
+            long residue() const {
+                return capacity - flow;
+            }
+        };
+
+        // all arcs of the paired list, the reverse ones included
+        std::span<const Edge> arcs() const { return m_edges; }
+        std::vector<Edge> edges() const;
+        std::vector<long> flows() const;
+
+        inline static long INF = 1e18;
+
+    private:
+        void refine(long epsilon);
+        bool refinePrices(long epsilon);
+        void discharge(int node, long epsilon);
+        void push(int idx, long amount);
+        void relabel(int node, long epsilon);
+
+        long reduced(int idx) const {
+            const Edge & edge = m_edges[idx];
+            return m_scaled[idx] + m_price[edge.from] - m_price[edge.to];
+        }
+
+        std::vector<std::vector<int>> m_adjacent;
+        std::vector<Edge> m_edges;
+
+        std::vector<long> m_scaled; // costs times N + 1
+        std::vector<long> m_price;
+        std::vector<long> m_excess;
+        std::vector<size_t> m_current;
+        std::vector<int> m_queue; // FIFO of active nodes, as a ring
+        size_t m_head = 0, m_size = 0;
+        std::vector<long> m_distance;
+        size_t m_refines = 0, m_skipped = 0;
+};
+
+inline CostScalingNetwork::CostScalingNetwork(size_t noNodes)
+: m_adjacent(noNodes){
+}
+
+inline void CostScalingNetwork::addEdge(int a, int b, long cap, long cost) {
+    auto m = m_edges.size();
+    m_edges.emplace_back(Edge{a, b, cap, cost});
+    m_adjacent[a].push_back(m ++);
+    m_edges.emplace_back(Edge{b, a, 0, -cost});
+    m_adjacent[b].push_back(m);
+}
+
+// Returns the cost of flowLimit units, -1 if that much does not fit. Starts
+// from zero flow every time.
+inline long CostScalingNetwork::minCostFlow(int source, int target, long flowLimit) {
+    size_t N = m_adjacent.size();
+    long largest = 0;
+    for (Edge & edge : m_edges) {
+        edge.flow = 0;
+        largest = std::max(largest, std::abs(edge.cost));
+    }
+
+    // no simple path costs as much as the extra edge, its reduced cost never
+    // gets negative before there is a flow, so it does not count for epsilon
+    long epsilon = std::max(1L, largest * (long)(N + 1));
+    addEdge(source, target, flowLimit, (largest + 1) * (long)N);
+    int extra = m_edges.size() - 2;
+
+    m_scaled.resize(m_edges.size());
+    for (size_t idx = 0; idx < m_edges.size(); ++ idx) {
+        m_scaled[idx] = m_edges[idx].cost * (long)(N + 1);
+    }
+    m_price.assign(N, 0);
+    m_excess.assign(N, 0);
+    m_current.assign(N, 0);
+    m_queue.resize(N);
+    m_excess[source] += flowLimit;
+    m_excess[target] -= flowLimit;
+
+    bool feasible = false; // the flow is a flow, not just a pseudoflow
+    do {
+        epsilon = std::max(1L, epsilon / 4);
+        if (feasible && refinePrices(epsilon)) {
+            ++ m_skipped;
+            continue;
+        }
+        refine(epsilon);
+        feasible = true;
+    } while (epsilon > 1);
+
+    bool fits = m_edges[extra].flow == 0;
+    m_edges.erase(m_edges.begin() + extra, m_edges.end());
+    m_adjacent[source].pop_back();
+    m_adjacent[target].pop_back();
+    if (!fits) return -1;
+
+    long cost = 0;
+    for (size_t idx = 0; idx < m_edges.size(); idx += 2) {
+        cost += m_edges[idx].flow * m_edges[idx].cost;
+    }
+    return cost;
+}
+
+inline void CostScalingNetwork::refine(long epsilon) {
+    ++ m_refines;
+    for (size_t idx = 0; idx < m_edges.size(); ++ idx) {
+        if (m_edges[idx].residue() > 0 && reduced(idx) < 0) push(idx, m_edges[idx].residue());
+    }
+
+    m_head = m_size = 0;
+    for (size_t v = 0; v < m_adjacent.size(); ++ v) {
+        m_current[v] = 0;
+        if (m_excess[v] > 0) m_queue[m_size ++] = v;
+    }
+    while (m_size > 0) {
+        int node = m_queue[m_head];
+        m_head = (m_head + 1) % m_queue.size();
+        -- m_size;
+        discharge(node, epsilon);
+    }
+}
+
+inline void CostScalingNetwork::discharge(int node, long epsilon) {
+    const std::vector<int> & adjacent = m_adjacent[node];
+    while (m_excess[node] > 0) {
+        for (size_t & i = m_current[node]; i < adjacent.size(); ++ i) {
+            int idx = adjacent[i];
+            if (m_edges[idx].residue() > 0 && reduced(idx) < 0) {
+                int next = m_edges[idx].to;
+                bool active = m_excess[next] > 0;
+                push(idx, std::min(m_excess[node], m_edges[idx].residue()));
+                if (!active && m_excess[next] > 0) {
+                    m_queue[(m_head + m_size ++) % m_queue.size()] = next;
+                }
+                if (m_excess[node] == 0) return;
+            }
+        }
+        relabel(node, epsilon);
+    }
+}
+
+inline void CostScalingNetwork::push(int idx, long amount) {
+    Edge & edge = m_edges[idx];
+    edge.flow += amount;
+    m_edges[idx ^ 1].flow -= amount;
+    m_excess[edge.from] -= amount;
+    m_excess[edge.to] += amount;
+}
+
+// Lowers the price just enough to make the cheapest residual edge admissible,
+// no residual edge gets below -epsilon.
+inline void CostScalingNetwork::relabel(int node, long epsilon) {
+    long price = -INF;
+    for (int idx : m_adjacent[node]) {
+        if (m_edges[idx].residue() > 0) {
+            price = std::max(price, m_price[m_edges[idx].to] - m_scaled[idx]);
+        }
+    }
+    m_price[node] = price - epsilon;
+    m_current[node] = 0;
+}
+// Prices p + d are epsilon-optimal for d shortest distances (from everywhere)
+// by lengths reduced cost + epsilon, if these have no negative cycle. Gives up
+// after a few rounds of Bellman-Ford.
+inline bool CostScalingNetwork::refinePrices(long epsilon) {
+    const int rounds = 4;
+    m_distance.assign(m_adjacent.size(), 0);
+    for (int round = 0; round < rounds; ++ round) {
+        bool changed = false;
+        for (size_t idx = 0; idx < m_edges.size(); ++ idx) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() == 0) continue;
+            long length = reduced(idx) + epsilon;
+            if (m_distance[edge.from] + length < m_distance[edge.to]) {
+                m_distance[edge.to] = m_distance[edge.from] + length;
+                changed = true;
+            }
+        }
+        if (!changed) {
+            for (size_t v = 0; v < m_price.size(); ++ v) m_price[v] += m_distance[v];
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every edge in addEdge order, the same numbering as flows.
+inline std::vector<CostScalingNetwork::Edge> CostScalingNetwork::edges() const {
+    std::vector<Edge> edges;
+    edges.reserve(m_edges.size() / 2);
+    for (size_t i = 0; i < m_edges.size(); i += 2) edges.push_back(m_edges[i]);
+    return edges;
+}
+
+// Flow of every edge in addEdge order.
+inline std::vector<long> CostScalingNetwork::flows() const {
+    std::vector<long> flows(m_edges.size() / 2);
+    for (size_t i = 0; i < flows.size(); ++ i) {
+        flows[i] = m_edges[2 * i].flow;
+    }
+    return flows;
+}
@@ -0,0 +1,96 @@
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "min-cost-circulation.h"
+#include "network-simplex.h"
+
+// Two shifts a day, each needs at least 2 and at most 4 workers. Workers go
+// from the depot (0) to the morning shift (1) or the evening shift (2) and
+// back, a worker costs 3 in the morning and 5 in the evening.
+void testShifts() {
+    MinCostCirculation g(3);
+    g.addEdge(0, 1, 0, 10, 0);
+    g.addEdge(0, 2, 0, 10, 0);
+    g.addEdge(1, 0, 2, 4, 3);
+    g.addEdge(2, 0, 2, 4, 5);
+    assert(g.solve());
+    assert(g.cost() == 2 * 3 + 2 * 5);
+    auto flows = g.flows();
+    assert(flows[0] == 2 && flows[1] == 2 && flows[2] == 2 && flows[3] == 2);
+
+    // a shift earns 4 a worker, the morning shift pays off up to its upper bound
+    MinCostCirculation h(3);
+    h.addEdge(0, 1, 0, 10, -4);
+    h.addEdge(0, 2, 0, 10, -4);
+    h.addEdge(1, 0, 2, 4, 3);
+    h.addEdge(2, 0, 2, 4, 5);
+    assert(h.solve());
+    assert(h.cost() == 4 * (3 - 4) + 2 * (5 - 4));
+    assert(h.flows()[2] == 4 && h.flows()[3] == 2);
+}
+
+void testInfeasible() {
+    // at least 3 units into node 1, at most 2 out of it
+    MinCostCirculation g(2);
+    g.addEdge(0, 1, 3, 5, 1);
+    g.addEdge(1, 0, 0, 2, 1);
+    assert(!g.solve());
+
+    // lower bound over the upper one
+    MinCostCirculation h(2);
+    h.addEdge(0, 1, 2, 1, 1);
+    h.addEdge(1, 0, 0, 5, 1);
+    assert(!h.solve());
+}
+
+// The lower bounds become supplies of the simplex: the flow of lower units is
+// sent beforehand, the rest fits into upper - lower.
+void testRandom() {
+    std::mt19937 random(5);
+    for (int round = 0; round < 1000; ++ round) {
+        int N = 2 + random() % 10, M = random() % 30;
+        MinCostCirculation circulation(N);
+        NetworkSimplex simplex(N);
+        std::vector<long> supply(N, 0);
+        std::vector<long> lower(M), upper(M), costs(M);
+        std::vector<int> from(M), to(M);
+        long fixedCost = 0;
+        for (int i = 0; i < M; ++ i) {
+            from[i] = random() % N, to[i] = random() % N;
+            lower[i] = random() % 3 == 0 ? random() % 4 : 0;
+            upper[i] = lower[i] + random() % 8;
+            costs[i] = (long)(random() % 20) - 10;
+            circulation.addEdge(from[i], to[i], lower[i], upper[i], costs[i]);
+            simplex.addEdge(from[i], to[i], upper[i] - lower[i], costs[i]);
+            supply[to[i]] += lower[i];
+            supply[from[i]] -= lower[i];
+            fixedCost += lower[i] * costs[i];
+        }
+        for (int v = 0; v < N; ++ v) simplex.setSupply(v, supply[v]);
+
+        bool feasible = simplex.solve();
+        assert(circulation.solve() == feasible);
+        if (!feasible) continue;
+        assert(circulation.cost() == fixedCost + simplex.cost());
+
+        // the flows keep the bounds and the conservation and add up to the cost
+        std::vector<long> balance(N, 0);
+        long cost = 0;
+        auto flows = circulation.flows();
+        for (int i = 0; i < M; ++ i) {
+            assert(lower[i] <= flows[i] && flows[i] <= upper[i]);
+            balance[from[i]] -= flows[i];
+            balance[to[i]] += flows[i];
+            cost += flows[i] * costs[i];
+        }
+        for (int v = 0; v < N; ++ v) assert(balance[v] == 0);
+        assert(cost == circulation.cost());
+    }
+}
+
+int main () {
+    testShifts();
+    testInfeasible();
+    testRandom();
+}
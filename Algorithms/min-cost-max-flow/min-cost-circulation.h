@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <span>
+
+#include "cost-flow-network.h"
+
+// Min cost circulation where every edge carries between lower and upper
+// units, costs may be negative. The lower bounds are sent up front: the edge
+// keeps upper - lower of capacity, its head gets lower units of excess and
+// its tail as much deficit. A super source feeds the excesses and a super
+// target drains the deficits, the circulation exists iff CostFlowNetwork can
+// send all the excess; its SPFA cancels the negative cycles before the
+// shortest paths, which makes the result of minimum cost.
+class MinCostCirculation {
+    public:
+        MinCostCirculation(size_t noNodes);
+        void addEdge(int a, int b, long lower, long upper, long cost);
+
+        // false if no circulation fits the bounds
+        bool solve();
+        long cost() const { return m_cost; }
+
+        // valid after a successful solve, edges in addEdge order
+        std::span<const long> flows() const { return m_flows; }
+
+    private:
+        struct Bounded {
+            int from, to;
+            long lower, upper, cost;
+        };
+
+        size_t m_nodes;
+        std::vector<Bounded> m_edges;
+        std::vector<long> m_flows;
+        long m_cost = 0;
+};
+
+inline MinCostCirculation::MinCostCirculation(size_t noNodes)
+: m_nodes(noNodes) {
+}
+
+inline void MinCostCirculation::addEdge(int a, int b, long lower, long upper, long cost) {
+    m_edges.push_back(Bounded{a, b, lower, upper, cost});
+}
+
+inline bool MinCostCirculation::solve() {
+    size_t N = m_nodes;
+    int source = N, target = N + 1;
+    CostFlowNetwork network(N + 2);
+    std::vector<long> excess(N, 0);
+    long fixedCost = 0;
+    for (const Bounded & edge : m_edges) {
+        if (edge.lower > edge.upper) return false;
+        network.addEdge(edge.from, edge.to, edge.upper - edge.lower, edge.cost);
+        excess[edge.to] += edge.lower;
+        excess[edge.from] -= edge.lower;
+        fixedCost += edge.lower * edge.cost;
+    }
+
+    long required = 0;
+    for (size_t v = 0; v < N; ++ v) {
+        if (excess[v] > 0) {
+            network.addEdge(source, v, excess[v], 0);
+            required += excess[v];
+        } else if (excess[v] < 0) {
+            network.addEdge(v, target, -excess[v], 0);
+        }
+    }
+
+    // the returned cost cannot tell a shortfall from a cost of -1, count the flow
+    long cost = network.minCostFlow(source, target, required);
+    auto flows = network.flows();
+    auto edges = network.edges();
+    long sent = 0;
+    for (size_t i = m_edges.size(); i < flows.size(); ++ i) {
+        if (edges[i].from == source) sent += flows[i];
+    }
+    if (sent < required) return false;
+
+    m_cost = fixedCost + cost;
+    m_flows.resize(m_edges.size());
+    for (size_t i = 0; i < m_edges.size(); ++ i) {
+        m_flows[i] = m_edges[i].lower + flows[i];
+    }
+    return true;
+}
@@ -0,0 +1,123 @@
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "network-simplex.h"
+#include "cost-flow-network.h"
+
+void testChat() {
+    NetworkSimplex g(6);
+    g.addEdge(0, 1, 10, 2);
+    g.addEdge(0, 2, 5, 6);
+    g.addEdge(1, 2, 15, 1);
+    g.addEdge(1, 3, 10, 4);
+    g.addEdge(2, 4, 10, 2);
+    g.addEdge(3, 4, 10, 3);
+    g.addEdge(3, 5, 10, 1);
+    g.addEdge(4, 5, 10, 2);
+
+    assert(g.minCostFlow(0, 5, 15) == 120);
+    // more than the max flow
+    assert(g.minCostFlow(0, 5, 21) == -1);
+    assert(g.minCostFlow(0, 5, 15) == 120);
+}
+
+// Two warehouses supply three shops, every pair is connected.
+void testTransportation() {
+    NetworkSimplex g(5);
+    long costs[2][3] = {{4, 6, 9}, {5, 3, 8}};
+    for (int a = 0; a < 2; ++ a) {
+        for (int b = 0; b < 3; ++ b) {
+            g.addEdge(a, 2 + b, NetworkSimplex::INF, costs[a][b]);
+        }
+    }
+    g.setSupply(0, 30);
+    g.setSupply(1, 25);
+    g.setSupply(2, -20);
+    g.setSupply(3, -15);
+    g.setSupply(4, -20);
+
+    assert(g.solve());
+    // 20 to the first shop and 10 to the last one from the first warehouse,
+    // the rest from the second
+    assert(g.cost() == 20 * 4 + 10 * 9 + 15 * 3 + 10 * 8);
+    auto flows = g.flows();
+    assert(flows[0] == 20 && flows[2] == 10 && flows[4] == 15 && flows[5] == 10);
+
+    // supplies which do not sum up to zero
+    g.setSupply(4, -21);
+    assert(!g.solve());
+}
+
+// A negative cycle is saturated even without any supply.
+void testNegativeCycle() {
+    NetworkSimplex g(3);
+    g.addEdge(0, 1, 4, -5);
+    g.addEdge(1, 2, 3, 1);
+    g.addEdge(2, 0, 7, 1);
+    assert(g.solve());
+    assert(g.cost() == -9);
+}
+
+// Same costs as CostFlowNetwork with a super source and target, and the
+// potentials satisfy the complementary slackness.
+void testRandom() {
+    std::mt19937 random(5);
+    for (int round = 0; round < 1000; ++ round) {
+        int N = 2 + random() % 15, M = random() % 50;
+        NetworkSimplex simplex(N);
+        CostFlowNetwork network(N + 2);
+        std::vector<int> from(M), to(M);
+        std::vector<long> capacity(M), cost(M);
+        for (int i = 0; i < M; ++ i) {
+            from[i] = random() % N;
+            to[i] = random() % N;
+            capacity[i] = random() % 10;
+            cost[i] = random() % 20;
+            simplex.addEdge(from[i], to[i], capacity[i], cost[i]);
+            network.addEdge(from[i], to[i], capacity[i], cost[i]);
+        }
+
+        std::vector<long> supply(N, 0);
+        long total = 0;
+        for (int i = 0; i < 4; ++ i) {
+            long amount = random() % 8;
+            supply[random() % N] += amount;
+            supply[random() % N] -= amount;
+        }
+        for (int v = 0; v < N; ++ v) {
+            simplex.setSupply(v, supply[v]);
+            if (supply[v] > 0) {
+                network.addEdge(N, v, supply[v], 0);
+                total += supply[v];
+            }
+            if (supply[v] < 0) network.addEdge(v, N + 1, -supply[v], 0);
+        }
+
+        long expected = network.minCostFlow(N, N + 1, total);
+        bool feasible = simplex.solve();
+        assert(feasible == (expected != -1));
+        if (!feasible) continue;
+        assert(simplex.cost() == expected);
+
+        auto flows = simplex.flows();
+        auto potential = simplex.potentials();
+        std::vector<long> balance(N, 0);
+        for (int i = 0; i < M; ++ i) {
+            assert(flows[i] >= 0 && flows[i] <= capacity[i]);
+            balance[from[i]] += flows[i];
+            balance[to[i]] -= flows[i];
+            long reduced = cost[i] + potential[from[i]] - potential[to[i]];
+            if (flows[i] < capacity[i]) assert(reduced >= 0);
+            if (flows[i] > 0) assert(reduced <= 0);
+        }
+        assert(balance == supply);
+    }
+}
+
+int main () {
+    testChat();
+    testTransportation();
+    testNegativeCycle();
+    testRandom();
+}
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <algorithm>
+
+// Min cost flow with a supply at every node (positive supply, negative
+// demand) by the primal network simplex. The basis is a spanning tree of an
+// extra root node: it starts with an artificial edge between the root and
+// every node carrying its supply, the artificial edges towards demand nodes
+// cost more than any path. Edges out of the tree are at zero flow or full.
+// Every pivot picks an edge which violates its bound by the block search
+// (scan a block of about sqrt(M) edges from where the last search stopped,
+// take the most violating one), pushes flow around the cycle it closes with
+// the tree and swaps it with the edge which limits the flow. The leaving edge
+// is the last limiting one in the direction of the cycle, which keeps the tree
+// strongly feasible and prevents cycling on degenerate pivots.
+// The tree is stored as parent pointers with child lists, the subtree which
+// gets hanged under the entering edge is walked to update its depths and
+// potentials. Potentials are the duals: reduced cost
+// cost + p[from] - p[to] is 0 on tree edges, >= 0 on edges without flow
+// and <= 0 on full edges. Edges on a negative cycle need a finite capacity.
+class NetworkSimplex {
+    public:
+        NetworkSimplex(size_t noNodes);
+        void addEdge(int a, int b, long cap, long cost);
+        void setSupply(int node, long supply);
+
+        bool solve();
+        long minCostFlow(int source, int target, long flowLimit);
+
+        long cost() const { return m_cost; }
+        size_t pivots() const { return m_pivots; }
+
+        // valid after a successful solve, edges in addEdge order
+        std::span<const long> flows() const { return std::span<const long>(m_flow).first(m_edges); }
+        std::span<const long> potentials() const { return std::span<const long>(m_potential).first(m_nodes); }
+
+        inline static long INF = 1e18;
+
+    private:
+        void init();
+        int findEntering();
+        void pivot(int entering);
+        void hang(int node, int parent, int edge, int direction);
+        void unhang(int node);
+        void shift(int root, long delta);
+
+        long reduced(int edge) const {
+            return m_edgeCost[edge] + m_potential[m_from[edge]] - m_potential[m_to[edge]];
+        }
+
+        // bound of an edge out of the tree, or in it
+        static constexpr int LOWER = 1, TREE = 0, UPPER = -1;
+        // tree edge to the parent leaves the node (UP) or enters it (DOWN)
+        static constexpr int UP = 1, DOWN = -1;
+
+        size_t m_nodes;
+        size_t m_edges = 0;
+        std::vector<long> m_supply;
+
+        // real edges first, the artificial edge of node v is m_edges + v
+        std::vector<int> m_from, m_to;
+        std::vector<long> m_capacity, m_edgeCost, m_flow;
+        std::vector<int> m_state;
+
+        // spanning tree, the root is node m_nodes
+        std::vector<int> m_parent, m_pred, m_direction, m_depth;
+        std::vector<int> m_child, m_next, m_prev; // child lists
+        std::vector<long> m_potential;
+        std::vector<int> m_stack;
+
+        size_t m_blockSize = 0, m_nextEdge = 0;
+        long m_cost = 0;
+        size_t m_pivots = 0;
+};
+
+inline NetworkSimplex::NetworkSimplex(size_t noNodes)
+: m_nodes(noNodes)
+, m_supply(noNodes, 0) {
+}
+
+inline void NetworkSimplex::addEdge(int a, int b, long cap, long cost) {
+    m_from.push_back(a);
+    m_to.push_back(b);
+    m_capacity.push_back(cap);
+    m_edgeCost.push_back(cost);
+    ++ m_edges;
+}
+
+inline void NetworkSimplex::setSupply(int node, long supply) {
+    m_supply[node] = supply;
+}
+
+// Returns false if the supplies do not sum up to zero or cannot be routed.
+inline bool NetworkSimplex::solve() {
+    m_cost = 0;
+    long total = 0;
+    for (long supply : m_supply) total += supply;
+    if (total != 0) return false;
+
+    init();
+    for (int entering; (entering = findEntering()) != -1; ) {
+        ++ m_pivots;
+        pivot(entering);
+    }
+    m_from.resize(m_edges);
+    m_to.resize(m_edges);
+    m_capacity.resize(m_edges);
+    m_edgeCost.resize(m_edges);
+
+    // flow left on an artificial edge crosses the root, it has nowhere else to go
+    for (size_t v = 0; v < m_nodes; ++ v) {
+        if (m_flow[m_edges + v] != 0) return false;
+    }
+    for (size_t i = 0; i < m_edges; ++ i) {
+        m_cost += m_flow[i] * m_edgeCost[i];
+    }
+    return true;
+}
+
+// Returns the cost of flowLimit units from the source to the target, -1 if
+// that much does not fit. Supplies of the other nodes are left out.
+inline long NetworkSimplex::minCostFlow(int source, int target, long flowLimit) {
+    std::vector<long> supply(m_nodes, 0);
+    supply[source] += flowLimit;
+    supply[target] -= flowLimit;
+    std::swap(supply, m_supply);
+    bool feasible = solve();
+    std::swap(supply, m_supply);
+    return feasible ? m_cost : -1;
+}
+
+inline void NetworkSimplex::init() {
+    size_t N = m_nodes, M = m_edges;
+    int root = N;
+
+    // more than the cost of any path
+    long largest = 0;
+    for (size_t i = 0; i < M; ++ i) largest = std::max(largest, std::abs(m_edgeCost[i]));
+    long artificial = (largest + 1) * (N + 1);
+
+    m_from.resize(M + N);
+    m_to.resize(M + N);
+    m_capacity.resize(M + N);
+    m_edgeCost.resize(M + N);
+    m_flow.assign(M + N, 0);
+    m_state.assign(M + N, LOWER);
+
+    m_parent.assign(N + 1, -1);
+    m_pred.assign(N + 1, -1);
+    m_direction.assign(N + 1, UP);
+    m_depth.assign(N + 1, 1);
+    m_child.assign(N + 1, -1);
+    m_next.assign(N + 1, -1);
+    m_prev.assign(N + 1, -1);
+    m_potential.assign(N + 1, 0);
+    m_depth[root] = 0;
+
+    for (size_t v = 0; v < N; ++ v) {
+        int edge = M + v;
+        m_capacity[edge] = INF;
+        m_state[edge] = TREE;
+        if (m_supply[v] >= 0) {
+            m_from[edge] = v;
+            m_to[edge] = root;
+            m_edgeCost[edge] = 0;
+            m_flow[edge] = m_supply[v];
+            hang(v, root, edge, UP);
+        } else {
+            m_from[edge] = root;
+            m_to[edge] = v;
+            m_edgeCost[edge] = artificial;
+            m_flow[edge] = -m_supply[v];
+            m_potential[v] = artificial;
+            hang(v, root, edge, DOWN);
+        }
+    }
+
+    m_blockSize = std::max<size_t>(10, std::sqrt(M));
+    m_nextEdge = 0;
+    m_pivots = 0;
+}
+
+// Block search over the real edges, -1 when the flow is optimal.
+inline int NetworkSimplex::findEntering() {
+    size_t M = m_edges;
+    int best = -1;
+    long violation = 0;
+    size_t count = 0;
+    for (size_t scanned = 0; scanned < M; ++ scanned) {
+        size_t edge = m_nextEdge;
+        if (++ m_nextEdge == M) m_nextEdge = 0;
+
+        long v = m_state[edge] * reduced(edge);
+        if (v < violation) {
+            violation = v;
+            best = edge;
+        }
+        if (++ count == m_blockSize) {
+            if (best != -1) break;
+            count = 0;
+        }
+    }
+    return best;
+}
+
+inline void NetworkSimplex::pivot(int entering) {
+    // flow goes around the cycle first -> second -> tree path -> first
+    int first = m_from[entering], second = m_to[entering];
+    if (m_state[entering] == UPPER) std::swap(first, second);
+
+    int join = first;
+    for (int other = second; join != other; ) {
+        if (m_depth[join] < m_depth[other]) std::swap(join, other);
+        join = m_parent[join];
+    }
+
+    // leaving edge, ties go to the last one along the cycle
+    long delta = m_capacity[entering];
+    int leaving = -1;
+    bool firstSide = false;
+    for (int u = first; u != join; u = m_parent[u]) {
+        int edge = m_pred[u];
+        long residue = m_direction[u] == DOWN ? m_capacity[edge] - m_flow[edge] : m_flow[edge];
+        if (residue < delta) {
+            delta = residue;
+            leaving = u;
+            firstSide = true;
+        }
+    }
+    for (int u = second; u != join; u = m_parent[u]) {
+        int edge = m_pred[u];
+        long residue = m_direction[u] == UP ? m_capacity[edge] - m_flow[edge] : m_flow[edge];
+        if (residue <= delta) {
+            delta = residue;
+            leaving = u;
+            firstSide = false;
+        }
+    }
+
+    if (delta > 0) {
+        long amount = m_state[entering] * delta;
+        m_flow[entering] += amount;
+        for (int u = m_from[entering]; u != join; u = m_parent[u]) {
+            m_flow[m_pred[u]] -= m_direction[u] * amount;
+        }
+        for (int u = m_to[entering]; u != join; u = m_parent[u]) {
+            m_flow[m_pred[u]] += m_direction[u] * amount;
+        }
+    }
+
+    if (leaving == -1) {
+        // the entering edge itself limits the flow, it goes to its other bound
+        m_state[entering] = -m_state[entering];
+        return;
+    }
+
+    int out = m_pred[leaving];
+    m_state[entering] = TREE;
+    m_state[out] = m_flow[out] == 0 ? LOWER : UPPER;
+
+    // the subtree of leaving is rehanged under the entering edge, the path
+    // from the entering node up to leaving gets reversed
+    int node = firstSide ? first : second;
+    int parent = firstSide ? second : first;
+    long sigma = node == m_to[entering] ? reduced(entering) : -reduced(entering);
+    int edge = entering;
+    int direction = node == m_from[entering] ? UP : DOWN;
+    while (true) {
+        int oldParent = m_parent[node], oldEdge = m_pred[node], oldDirection = m_direction[node];
+        unhang(node);
+        hang(node, parent, edge, direction);
+        if (node == leaving) break;
+        parent = node;
+        edge = oldEdge;
+        direction = -oldDirection;
+        node = oldParent;
+    }
+
+    shift(firstSide ? first : second, sigma);
+}
+
+inline void NetworkSimplex::hang(int node, int parent, int edge, int direction) {
+    m_parent[node] = parent;
+    m_pred[node] = edge;
+    m_direction[node] = direction;
+    m_prev[node] = -1;
+    m_next[node] = m_child[parent];
+    if (m_child[parent] != -1) m_prev[m_child[parent]] = node;
+    m_child[parent] = node;
+}
+
+inline void NetworkSimplex::unhang(int node) {
+    if (m_prev[node] != -1) m_next[m_prev[node]] = m_next[node];
+    else m_child[m_parent[node]] = m_next[node];
+    if (m_next[node] != -1) m_prev[m_next[node]] = m_prev[node];
+}
+
+// Adds delta to the potentials of the subtree and fixes its depths.
+inline void NetworkSimplex::shift(int root, long delta) {
+    m_stack.clear();
+    m_stack.push_back(root);
+    while (!m_stack.empty()) {
+        int node = m_stack.back();
+        m_stack.pop_back();
+        m_potential[node] += delta;
+        m_depth[node] = m_depth[m_parent[node]] + 1;
+        for (int child = m_child[node]; child != -1; child = m_next[child]) {
+            m_stack.push_back(child);
+        }
+    }
+}
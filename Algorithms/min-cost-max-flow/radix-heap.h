@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <bit>
+#include <cstdint>
+
+// Monotone priority queue for Dijkstra with non-negative integer keys: no key
+// pushed may be smaller than the last one popped. Bucket i holds keys which
+// first differ from the last popped key in bit i - 1, when bucket 0 runs
+// empty the smallest nonempty bucket is redistributed into lower ones. Every
+// element moves down at most 64 times, O(log C) amortized per operation.
+template <class Value>
+class RadixHeap {
+    public:
+        void push(uint64_t key, Value value) {
+            m_buckets[bucket(key)].emplace_back(key, value);
+            ++ m_size;
+        }
+
+        // smallest key and its value
+        std::pair<uint64_t, Value> pop() {
+            if (m_buckets[0].empty()) refill();
+            auto top = m_buckets[0].back();
+            m_buckets[0].pop_back();
+            -- m_size;
+            return top;
+        }
+
+        bool empty() const { return m_size == 0; }
+
+        void clear() {
+            for (auto & bucket : m_buckets) bucket.clear();
+            m_last = 0;
+            m_size = 0;
+        }
+
+    private:
+        size_t bucket(uint64_t key) const {
+            return key == m_last ? 0 : 64 - std::countl_zero(key ^ m_last);
+        }
+
+        void refill() {
+            size_t i = 1;
+            while (m_buckets[i].empty()) ++ i;
+            uint64_t minimum = m_buckets[i][0].first;
+            for (const auto & [key, value] : m_buckets[i]) minimum = std::min(minimum, key);
+            m_last = minimum;
+            for (const auto & [key, value] : m_buckets[i]) {
+                m_buckets[bucket(key)].emplace_back(key, value);
+            }
+            m_buckets[i].clear();
+        }
+
+        std::array<std::vector<std::pair<uint64_t, Value>>, 65> m_buckets;
+        uint64_t m_last = 0;
+        size_t m_size = 0;
+};
@@ -0,0 +1,233 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+
+#include "graph.h"
+#include "dijkstra.h"
+#include "contraction-hierarchy.h"
+#include "delta-stepping.h"
+
+// Compares the priority queues of Dijkstra on road-style graphs: a side x side
+// grid of two-way roads with travel times 100 .. 1000, a tenth of the roads
+// missing, and some motorways which go 30 nodes straight at a third of the
+// time per node.
+// Then point to point queries between random nodes: a full search, the
+// bidirectional one and A* by 100 per step as the crow flies, which no road
+// beats.
+// Then the contraction hierarchy: its preprocessing, the size of the saved
+// index and its queries on the same pairs.
+// Last delta-stepping against Dijkstra on the roads and on a random graph of
+// 4 edges out of every node with weights 1 .. 1000, by threads and delta.
+// Usage: ./a.out [side ...]
+
+std::vector<CSRGraph::Edge> roads(int side) {
+    std::mt19937 random(side);
+    std::uniform_int_distribution<int> time(100, 1000);
+    std::vector<CSRGraph::Edge> edges;
+    auto road = [&](int a, int b, int weight) {
+        edges.push_back({a, b, weight});
+        edges.push_back({b, a, weight});
+    };
+    for (int y = 0; y < side; ++ y) {
+        for (int x = 0; x < side; ++ x) {
+            int node = y * side + x;
+            if (x + 1 < side && random() % 10 != 0) road(node, node + 1, time(random));
+            if (y + 1 < side && random() % 10 != 0) road(node, node + side, time(random));
+            if (x + 30 < side && random() % 200 == 0) road(node, node + 30, 30 * 100);
+            if (y + 30 < side && random() % 200 == 0) road(node, node + 30 * side, 30 * 100);
+        }
+    }
+    return edges;
+}
+
+template <class Queue>
+void run(const std::string & name, int side, const std::vector<CSRGraph::Edge> & edges, std::vector<long> & checksum) {
+    BasicDijkstra<Queue> graph(side * side, edges);
+    std::vector<long> dist;
+    std::vector<int> parent;
+    // the first search builds the CSR
+    graph.findPaths(0, dist, parent);
+
+    std::vector<long> sums;
+    auto begin = std::chrono::steady_clock::now();
+    for (int start : {0, side * side / 2 + side / 2, side * side - 1}) {
+        graph.findPaths(start, dist, parent);
+        long sum = 0;
+        for (long d : dist) sum += d == Graph::INF ? 0 : d;
+        sums.push_back(sum);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    if (checksum.empty()) checksum = sums;
+    if (sums != checksum) {
+        std::cerr << name << " differs\n";
+        std::exit(1);
+    }
+
+    std::cout << std::setw(14) << name
+              << std::setw(12) << std::fixed << std::setprecision(2) << elapsed.count() / 3 << "\n";
+}
+
+void compare(int side) {
+    auto edges = roads(side);
+    std::cout << "roads " << side << " x " << side << " (" << edges.size() << " edges)\n";
+    std::cout << std::setw(14) << "queue" << std::setw(12) << "ms/search" << "\n";
+    std::vector<long> checksum;
+    run<LazyBinaryHeap>("lazy binary", side, edges, checksum);
+    run<QuaternaryHeap>("4-ary", side, edges, checksum);
+    run<RadixQueue>("radix", side, edges, checksum);
+    std::cout << "\n";
+}
+
+// A query returns the length of the path and the nodes it settled.
+void runQueries(const std::string & name, const std::vector<std::pair<int, int>> & pairs,
+                const std::function<std::pair<long, size_t>(int, int)> & query, std::vector<long> & lengths) {
+    size_t settled = 0;
+    std::vector<long> found;
+    auto begin = std::chrono::steady_clock::now();
+    for (auto [source, target] : pairs) {
+        auto [length, nodes] = query(source, target);
+        found.push_back(length);
+        settled += nodes;
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - begin;
+    if (lengths.empty()) lengths = found;
+    if (found != lengths) {
+        std::cerr << name << " differs\n";
+        std::exit(1);
+    }
+    std::cout << std::setw(14) << name
+              << std::setw(12) << std::fixed << std::setprecision(1) << elapsed.count() / pairs.size()
+              << std::setw(12) << settled / pairs.size() << "\n";
+}
+
+void compareQueries(int side, int queries) {
+    auto edges = roads(side);
+    Dijkstra graph(side * side, edges);
+    std::mt19937 random(queries);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; ++ i) pairs.push_back({(int)(random() % (side * side)), (int)(random() % (side * side))});
+    std::vector<long> dist;
+    std::vector<int> parent;
+    graph.findPaths(0, dist, parent);
+
+    std::cout << "queries on roads " << side << " x " << side << "\n";
+    std::cout << std::setw(14) << "search" << std::setw(12) << "us/query" << std::setw(12) << "settled" << "\n";
+    std::vector<long> lengths;
+    runQueries("full", pairs, [&](int source, int target) {
+        graph.findPaths(source, dist, parent);
+        return std::pair<long, size_t>(dist[target], side * side);
+    }, lengths);
+    runQueries("bidirectional", pairs, [&](int source, int target) {
+        long length = graph.shortestPath(source, target);
+        return std::pair<long, size_t>(length, graph.settled());
+    }, lengths);
+    runQueries("A*", pairs, [&](int source, int target) {
+        long length = graph.shortestPath(source, target, [&](int v) {
+            return 100L * (std::abs(v % side - target % side) + std::abs(v / side - target / side));
+        });
+        return std::pair<long, size_t>(length, graph.settled());
+    }, lengths);
+    std::cout << "\n";
+}
+
+void compareHierarchy(int side, int queries) {
+    auto edges = roads(side);
+    std::cout << "contraction hierarchy of roads " << side << " x " << side << "\n";
+    auto begin = std::chrono::steady_clock::now();
+    ContractionHierarchy index(side * side, edges);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::stringstream stream;
+    index.save(stream);
+    auto bytes = stream.str().size();
+    begin = std::chrono::steady_clock::now();
+    ContractionHierarchy loaded = ContractionHierarchy::load(stream);
+    std::chrono::duration<double, std::milli> loading = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << "preprocessing" << std::setw(12) << std::fixed << std::setprecision(0) << elapsed.count() << " ms, "
+              << index.shortcuts() << " shortcuts, index " << std::setprecision(1) << bytes / double(1 << 20) << " MB loaded in "
+              << loading.count() << " ms\n";
+
+    Dijkstra graph(side * side, edges);
+    std::mt19937 random(queries);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; ++ i) pairs.push_back({(int)(random() % (side * side)), (int)(random() % (side * side))});
+    std::cout << std::setw(14) << "search" << std::setw(12) << "us/query" << std::setw(12) << "settled" << "\n";
+    std::vector<long> lengths;
+    runQueries("bidirectional", pairs, [&](int source, int target) {
+        long length = graph.shortestPath(source, target);
+        return std::pair<long, size_t>(length, graph.settled());
+    }, lengths);
+    runQueries("hierarchy", pairs, [&](int source, int target) {
+        long length = loaded.distance(source, target);
+        return std::pair<long, size_t>(length, loaded.settled());
+    }, lengths);
+    std::cout << "\n";
+}
+
+std::vector<CSRGraph::Edge> randomGraph(int N, int degree) {
+    std::mt19937 random(N);
+    std::uniform_int_distribution<int> node(0, N - 1), weight(1, 1000);
+    std::vector<CSRGraph::Edge> edges;
+    for (int a = 0; a < N; ++ a) {
+        for (int d = 0; d < degree; ++ d) edges.push_back({a, node(random), weight(random)});
+    }
+    return edges;
+}
+
+void compareDeltaStepping(const std::string & title, int N, const std::vector<CSRGraph::Edge> & edges) {
+    std::cout << "delta-stepping on " << title << " (" << N << " nodes, " << edges.size() << " edges)\n";
+    std::cout << std::setw(14) << "algorithm" << std::setw(8) << "delta" << std::setw(10) << "threads"
+              << std::setw(12) << "ms" << std::setw(10) << "rounds" << "\n";
+    std::vector<long> expected, dist;
+    std::vector<int> parent;
+    Dijkstra dijkstra(N, edges);
+    dijkstra.findPaths(0, expected, parent);
+    auto begin = std::chrono::steady_clock::now();
+    dijkstra.findPaths(0, expected, parent);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    std::cout << std::setw(14) << "dijkstra" << std::setw(30) << std::fixed << std::setprecision(2) << elapsed.count() << "\n";
+
+    DeltaStepping graph(N, edges);
+    graph.findPaths(0, dist, parent);
+    for (long delta : {0L, 100L, 1000L, 10000L}) {
+        for (unsigned threads : {1u, 2u, 4u, 8u}) {
+            graph.setDelta(delta);
+            graph.setThreads(threads);
+            begin = std::chrono::steady_clock::now();
+            graph.findPaths(0, dist, parent);
+            elapsed = std::chrono::steady_clock::now() - begin;
+            if (dist != expected) {
+                std::cerr << "delta-stepping differs\n";
+                std::exit(1);
+            }
+            std::cout << std::setw(14) << "delta-stepping" << std::setw(8) << (delta ? std::to_string(delta) : "auto")
+                      << std::setw(10) << threads << std::setw(12) << elapsed.count() << std::setw(10) << graph.rounds() << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+int main (int argc, char * argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++ i) {
+            compare(std::atoi(argv[i]));
+            compareQueries(std::atoi(argv[i]), 20);
+            // the preprocessing takes minutes above 600 x 600
+            if (std::atoi(argv[i]) <= 600) compareHierarchy(std::atoi(argv[i]), 1000);
+            int side = std::atoi(argv[i]);
+            compareDeltaStepping("roads", side * side, roads(side));
+        }
+        return 0;
+    }
+    for (int side : {300, 1000, 2000}) compare(side);
+    for (int side : {300, 1000, 2000}) compareQueries(side, 20);
+    for (int side : {300, 600}) compareHierarchy(side, 1000);
+    compareDeltaStepping("roads 1000 x 1000", 1000 * 1000, roads(1000));
+    compareDeltaStepping("a random graph", 2000000, randomGraph(2000000, 4));
+}
@@ -0,0 +1,165 @@
+#include <cassert>
+#include <random>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#include "contraction-hierarchy.h"
+#include "dijkstra.h"
+
+void testChat() {
+    std::vector<CSRGraph::Edge> edges = {
+        {0, 1, 5}, {0, 2, 35}, {0, 3, 40}, {1, 3, 20}, {1, 4, 25},
+        {2, 4, 30}, {2, 5, 30}, {3, 5, 20}, {4, 5, 25},
+    };
+    ContractionHierarchy index(6, edges);
+    assert(index.distance(0, 5) == 45);
+    assert(index.distance(0, 4) == 30);
+    assert(index.distance(2, 5) == 30);
+    assert(index.distance(5, 0) == ContractionHierarchy::INF);
+    assert(index.distance(3, 3) == 0);
+}
+
+// All pairs against Dijkstra, with parallel edges, loops and zero weights.
+void testRandom() {
+    std::mt19937 random(3);
+    for (int round = 0; round < 200; ++ round) {
+        int N = 1 + random() % 40, M = random() % 150;
+        std::vector<CSRGraph::Edge> edges;
+        for (int i = 0; i < M; ++ i) {
+            edges.push_back({(int)(random() % N), (int)(random() % N), (int)(random() % 30)});
+        }
+        ContractionHierarchy index(N, edges);
+        Dijkstra graph(N, edges);
+        std::vector<long> dist;
+        std::vector<int> parent;
+        for (int source = 0; source < N; ++ source) {
+            graph.findPaths(source, dist, parent);
+            for (int target = 0; target < N; ++ target) {
+                assert(index.distance(source, target) == dist[target]);
+            }
+        }
+    }
+}
+
+// A grid with roads both ways is what the index is made for.
+void testGrid() {
+    std::mt19937 random(5);
+    int side = 30;
+    std::vector<CSRGraph::Edge> edges;
+    for (int v = 0; v < side * side; ++ v) {
+        if (v % side + 1 < side) {
+            int weight = 10 + random() % 90;
+            edges.push_back({v, v + 1, weight});
+            edges.push_back({v + 1, v, weight});
+        }
+        if (v + side < side * side) {
+            int weight = 10 + random() % 90;
+            edges.push_back({v, v + side, weight});
+            edges.push_back({v + side, v, weight});
+        }
+    }
+    ContractionHierarchy index(side * side, edges);
+    Dijkstra graph(side * side, edges);
+    for (int query = 0; query < 200; ++ query) {
+        int source = random() % (side * side), target = random() % (side * side);
+        assert(index.distance(source, target) == graph.shortestPath(source, target));
+        assert(index.settled() < (size_t)(side * side));
+    }
+}
+
+// Shortcuts of weights up to 2 * 10^9 add up past 32 bits.
+void testHeavyWeights() {
+    std::mt19937 random(6);
+    for (int round = 0; round < 50; ++ round) {
+        int N = 2 + random() % 40, M = random() % 150;
+        std::vector<CSRGraph::Edge> edges;
+        for (int i = 0; i < M; ++ i) {
+            edges.push_back({(int)(random() % N), (int)(random() % N), (int)(1000000000 + random() % 1000000001)});
+        }
+        ContractionHierarchy index(N, edges);
+        std::stringstream stream;
+        index.save(stream);
+        ContractionHierarchy loaded = ContractionHierarchy::load(stream);
+        Dijkstra graph(N, edges);
+        std::vector<long> dist;
+        std::vector<int> parent;
+        for (int source = 0; source < N; ++ source) {
+            graph.findPaths(source, dist, parent);
+            for (int target = 0; target < N; ++ target) {
+                assert(index.distance(source, target) == dist[target]);
+                assert(loaded.distance(source, target) == dist[target]);
+            }
+        }
+    }
+}
+
+void testSerialization() {
+    std::mt19937 random(4);
+    int N = 50;
+    std::vector<CSRGraph::Edge> edges;
+    for (int i = 0; i < 200; ++ i) edges.push_back({(int)(random() % N), (int)(random() % N), (int)(random() % 100)});
+    ContractionHierarchy index(N, edges);
+
+    std::stringstream stream;
+    index.save(stream);
+    std::string bytes = stream.str();
+    ContractionHierarchy loaded = ContractionHierarchy::load(stream);
+    assert(loaded.size() == index.size() && loaded.shortcuts() == index.shortcuts());
+    for (int source = 0; source < N; ++ source) {
+        for (int target = 0; target < N; ++ target) {
+            assert(loaded.distance(source, target) == index.distance(source, target));
+        }
+    }
+
+    // another magic, a cut short index, sizes far beyond the bytes, a broken
+    // edge and a negative weight
+    auto broken = [](const std::string & bytes) {
+        std::stringstream stream(bytes);
+        try {
+            ContractionHierarchy::load(stream);
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    assert(broken("CHIY" + bytes.substr(4)));
+    assert(broken(bytes.substr(0, bytes.size() - 1)));
+    std::string edge = bytes;
+    // the first target of the upward graph, after the header, ranks and offsets
+    size_t first = 4 + 5 * 8 + N * 8 + (N + 1) * 8;
+    edge[first + 7] = (char)0x80;
+    assert(broken(edge));
+    for (uint64_t size : {uint64_t(1) << 61, uint64_t(1) << 30}) {
+        std::string huge = bytes;
+        std::memcpy(huge.data() + 4 + 8, &size, 8);
+        assert(broken(huge));
+    }
+    std::string weight = bytes;
+    uint64_t M;
+    std::memcpy(&M, bytes.data() + 4 + 2 * 8, 8);
+    int64_t negative = -100;
+    std::memcpy(weight.data() + first + M * 8, &negative, 8);
+    assert(broken(weight));
+
+    try {
+        ContractionHierarchy negative(2, {{0, 1, -1}});
+        assert("Exception should be thrown" == nullptr);
+    } catch (const std::invalid_argument &) {
+    }
+    try {
+        ContractionHierarchy outside(2, {{0, 2, 1}});
+        assert("Exception should be thrown" == nullptr);
+    } catch (const std::invalid_argument &) {
+    }
+}
+
+int main () {
+    testChat();
+    testRandom();
+    testGrid();
+    testHeavyWeights();
+    testSerialization();
+}
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <limits>
+
+#include "graph.h"
+#include "dijkstra.h"
+
+// Index for many point to point queries on a static graph with non-negative
+// weights. Nodes are contracted one by one: a contracted node leaves the
+// graph and for every pair of its neighbours u -> v -> w whose shortest path
+// goes through it a shortcut u -> w takes its place. A shortcut is not needed
+// when a witness search from u finds another path to w as short, the search
+// gives up after WITNESS_SETTLED nodes and adds the shortcut then.
+// The next node to contract is the one of the smallest priority: twice its
+// edge difference (shortcuts it needs minus the edges it removes), the
+// neighbours contracted before it and its level, one above the highest
+// contracted neighbour; the last two spread the contraction over the graph.
+// Priorities are updated lazily, a node which comes first is evaluated again
+// and goes back if it is not first any more.
+// The rank of a node is its place in the order. Every shortest path goes up
+// the ranks and then down, so a query searches upwards from the source in
+// the edges towards higher ranks and upwards from the target in the edges
+// from higher ranks turned around; both are frozen into CSRGraphs and the
+// two searches settle a small part of the graph.
+// Shortcut weights are sums of edge weights, so both graphs keep 64 bit
+// weights.
+// A query writes the scratch of the searches kept in the index, one query
+// runs at a time on an index, as on BasicDijkstra.
+// The index is saved as: "CHIX", format version, N, the ranks, then the
+// offsets, targets and weights of the upward and the downward graph, all
+// integers 64 bits little endian.
+class ContractionHierarchy {
+    public:
+        ContractionHierarchy(size_t N, const std::vector<CSRGraph::Edge> & edges);
+
+        void save(std::ostream & out) const;
+        static ContractionHierarchy load(std::istream & in);
+
+        // INF if there is no path, not safe to call from several threads
+        long distance(int source, int target) const;
+
+        size_t size() const { return m_rank.size(); }
+        size_t shortcuts() const { return m_shortcuts; }
+        int rank(int node) const { return m_rank[node]; }
+        // nodes the last query settled
+        size_t settled() const { return m_settled; }
+
+        inline static long INF = Graph::INF;
+        static constexpr size_t WITNESS_SETTLED = 100;
+        static constexpr uint64_t FORMAT = 1;
+
+    private:
+        ContractionHierarchy() = default;
+
+        using ShortcutGraph = BasicCSRGraph<int64_t>;
+
+        // graph during the contraction, a contracted node keeps its own
+        // lists for the frozen graphs and leaves those of its neighbours
+        struct Arc {
+            int node;
+            long weight;
+        };
+        using Arcs = std::vector<std::vector<Arc>>;
+
+        void contract(Arcs & out, Arcs & in);
+        // shortcuts needed when contracting v, added to the graph if `add`
+        size_t shortcutsOf(int v, Arcs & out, Arcs & in, bool add);
+        void witnessSearch(int source, int avoid, long limit, const Arcs & out);
+        long priority(int v, Arcs & out, Arcs & in);
+        // a parallel arc only gets shorter
+        static void addArc(std::vector<Arc> & arcs, int node, long weight) {
+            for (Arc & arc : arcs) {
+                if (arc.node != node) continue;
+                arc.weight = std::min(arc.weight, weight);
+                return;
+            }
+            arcs.push_back({node, weight});
+        }
+        void freeze(const Arcs & out, const Arcs & in);
+
+        std::vector<int> m_rank;
+        // m_up: edges to higher ranks; m_down: edges from higher ranks, turned around
+        ShortcutGraph m_up, m_down;
+        size_t m_shortcuts = 0;
+
+        // scratch of the witness searches and the queries, valid where the
+        // stamp is the current search
+        struct Search {
+            std::vector<long> dist;
+            std::vector<unsigned> stamp;
+            QuaternaryHeap queue;
+        };
+        void start(Search & search) const;
+        void nextSearch() const;
+        long & distanceOf(Search & search, int node) const {
+            if (search.stamp[node] != m_search) {
+                search.stamp[node] = m_search;
+                search.dist[node] = INF;
+            }
+            return search.dist[node];
+        }
+
+        std::vector<bool> m_contracted;
+        std::vector<int> m_deleted;
+        std::vector<int> m_level;
+        // out-neighbours of the node being contracted, stamped with the search
+        mutable std::vector<unsigned> m_target;
+        mutable Search m_forward, m_backward;
+        mutable unsigned m_search = 0;
+        mutable size_t m_settled = 0;
+};
+
+inline ContractionHierarchy::ContractionHierarchy(size_t N, const std::vector<CSRGraph::Edge> & edges) {
+    Arcs out(N), in(N);
+    for (const CSRGraph::Edge & edge : edges) {
+        if (edge.weight < 0) throw std::invalid_argument("Negative weights are not allowed");
+        if (edge.from < 0 || edge.to < 0 || (size_t)edge.from >= N || (size_t)edge.to >= N) {
+            throw std::invalid_argument("Node of an edge out of range");
+        }
+        if (edge.from == edge.to) continue;
+        addArc(out[edge.from], edge.to, edge.weight);
+        addArc(in[edge.to], edge.from, edge.weight);
+    }
+    contract(out, in);
+    freeze(out, in);
+}
+
+inline void ContractionHierarchy::start(Search & search) const {
+    size_t N = m_rank.size();
+    if (search.stamp.size() != N) {
+        search.dist.resize(N);
+        search.stamp.assign(N, 0);
+        search.queue.reset(N);
+    }
+    search.queue.clear();
+}
+
+inline void ContractionHierarchy::nextSearch() const {
+    if (++ m_search == 0) {
+        // the stamps wrapped around, every node becomes untouched again
+        std::fill(m_forward.stamp.begin(), m_forward.stamp.end(), 0);
+        std::fill(m_backward.stamp.begin(), m_backward.stamp.end(), 0);
+        std::fill(m_target.begin(), m_target.end(), 0);
+        m_search = 1;
+    }
+}
+
+inline void ContractionHierarchy::contract(Arcs & out, Arcs & in) {
+    size_t N = out.size();
+    m_rank.assign(N, -1);
+    m_contracted.assign(N, false);
+    m_deleted.assign(N, 0);
+    m_level.assign(N, 0);
+    m_target.assign(N, 0);
+
+    std::vector<long> current(N);
+    std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>, std::greater<std::pair<long, int>>> order;
+    for (size_t v = 0; v < N; ++ v) {
+        current[v] = priority(v, out, in);
+        order.push({current[v], (int)v});
+    }
+
+    int rank = 0;
+    while (!order.empty()) {
+        auto [key, v] = order.top();
+        order.pop();
+        if (m_contracted[v] || key != current[v]) continue;
+        // lazy update: the priority may have grown since it was pushed
+        current[v] = priority(v, out, in);
+        if (!order.empty() && current[v] > order.top().first) {
+            order.push({current[v], v});
+            continue;
+        }
+
+        m_shortcuts += shortcutsOf(v, out, in, true);
+        m_contracted[v] = true;
+        m_rank[v] = rank ++;
+        auto leave = [v](std::vector<Arc> & arcs) {
+            arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [v](const Arc & arc) { return arc.node == v; }), arcs.end());
+        };
+        for (const Arc & arc : out[v]) leave(in[arc.node]);
+        for (const Arc & arc : in[v]) leave(out[arc.node]);
+        for (const Arcs * arcs : {&out, &in}) {
+            for (const Arc & arc : (*arcs)[v]) {
+                ++ m_deleted[arc.node];
+                m_level[arc.node] = std::max(m_level[arc.node], m_level[v] + 1);
+            }
+        }
+    }
+}
+
+inline long ContractionHierarchy::priority(int v, Arcs & out, Arcs & in) {
+    long removed = out[v].size() + in[v].size();
+    return 2 * ((long)shortcutsOf(v, out, in, false) - removed) + m_deleted[v] + m_level[v];
+}
+
+// Local Dijkstra from the source around the node being contracted, until
+// all its targets are settled.
+inline void ContractionHierarchy::witnessSearch(int source, int avoid, long limit, const Arcs & out) {
+    start(m_forward);
+    nextSearch();
+    size_t targets = 0;
+    for (const Arc & arc : out[avoid]) {
+        if (m_target[arc.node] != m_search) {
+            m_target[arc.node] = m_search;
+            ++ targets;
+        }
+    }
+    distanceOf(m_forward, source) = 0;
+    m_forward.queue.push(source, 0);
+    size_t settled = 0;
+    while (!m_forward.queue.empty()) {
+        auto [distance, current] = m_forward.queue.pop();
+        if (distance > limit || ++ settled > WITNESS_SETTLED) break;
+        if (m_target[current] == m_search && -- targets == 0) break;
+        for (const Arc & arc : out[current]) {
+            if (arc.node == avoid) continue;
+            long & next = distanceOf(m_forward, arc.node);
+            if (next > distance + arc.weight) {
+                next = distance + arc.weight;
+                m_forward.queue.push(arc.node, next);
+            }
+        }
+    }
+}
+
+inline size_t ContractionHierarchy::shortcutsOf(int v, Arcs & out, Arcs & in, bool add) {
+    long longest = 0;
+    for (const Arc & arc : out[v]) longest = std::max(longest, arc.weight);
+
+    size_t count = 0;
+    std::vector<Arc> shortcuts;
+    for (const Arc & from : in[v]) {
+        witnessSearch(from.node, v, from.weight + longest, out);
+        for (const Arc & to : out[v]) {
+            if (to.node == from.node) continue;
+            long via = from.weight + to.weight;
+            if (distanceOf(m_forward, to.node) <= via) continue;
+            ++ count;
+            if (add) shortcuts.push_back({to.node, via});
+        }
+        if (!add) continue;
+
+        for (const Arc & shortcut : shortcuts) {
+            addArc(out[from.node], shortcut.node, shortcut.weight);
+            addArc(in[shortcut.node], from.node, shortcut.weight);
+        }
+        shortcuts.clear();
+    }
+    return count;
+}
+
+// Every edge ends up in the graph of its lower end: an edge out of it goes
+// up, an edge into it comes down. Parallel edges keep the shortest one.
+inline void ContractionHierarchy::freeze(const Arcs & out, const Arcs & in) {
+    size_t N = out.size();
+    using Edge = ShortcutGraph::Edge;
+    std::vector<Edge> up, down;
+    for (size_t v = 0; v < N; ++ v) {
+        for (const Arc & arc : out[v]) {
+            if (m_rank[arc.node] > m_rank[v]) up.push_back({(int)v, arc.node, arc.weight});
+        }
+        for (const Arc & arc : in[v]) {
+            if (m_rank[arc.node] > m_rank[v]) down.push_back({(int)v, arc.node, arc.weight});
+        }
+    }
+    for (auto * edges : {&up, &down}) {
+        std::sort(edges->begin(), edges->end(), [](const Edge & a, const Edge & b) {
+            return a.from != b.from ? a.from < b.from : a.to != b.to ? a.to < b.to : a.weight < b.weight;
+        });
+        edges->erase(std::unique(edges->begin(), edges->end(), [](const Edge & a, const Edge & b) {
+            return a.from == b.from && a.to == b.to;
+        }), edges->end());
+    }
+    m_up = ShortcutGraph(N, up);
+    m_down = ShortcutGraph(N, down);
+    std::vector<bool>().swap(m_contracted);
+    std::vector<int>().swap(m_deleted);
+    std::vector<int>().swap(m_level);
+    std::vector<unsigned>().swap(m_target);
+}
+
+// Both searches go up; a side stops once its smallest key reaches the best
+// meeting, the meeting with the smallest sum is the distance.
+inline long ContractionHierarchy::distance(int source, int target) const {
+    Search * searches[2] = {&m_forward, &m_backward};
+    const ShortcutGraph * graphs[2] = {&m_up, &m_down};
+    start(m_forward);
+    start(m_backward);
+    nextSearch();
+    m_settled = 0;
+    distanceOf(m_forward, source) = 0;
+    m_forward.queue.push(source, 0);
+    distanceOf(m_backward, target) = 0;
+    m_backward.queue.push(target, 0);
+
+    long best = INF;
+    bool done[2] = {false, false};
+    for (int side = 0; !done[0] || !done[1]; side ^= 1) {
+        Search & search = *searches[side];
+        Search & other = *searches[side ^ 1];
+        if (done[side]) continue;
+        if (search.queue.empty()) {
+            done[side] = true;
+            continue;
+        }
+        auto [distance, current] = search.queue.pop();
+        if (distance >= best) {
+            done[side] = true;
+            continue;
+        }
+        ++ m_settled;
+        if (other.stamp[current] == m_search) best = std::min(best, distance + other.dist[current]);
+
+        const ShortcutGraph & graph = *graphs[side];
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            long & next = distanceOf(search, graph.targets[i]);
+            if (next > distance + graph.weights[i]) {
+                next = distance + graph.weights[i];
+                search.queue.push(graph.targets[i], next);
+            }
+        }
+    }
+    return best;
+}
+
+namespace detail {
+    template <class T>
+    void write(std::ostream & out, const std::vector<T> & values) {
+        out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    // bytes left in the stream, -1 if it cannot seek
+    inline std::streamoff remaining(std::istream & in) {
+        std::streampos at = in.tellg();
+        if (at == std::streampos(-1) || !in.seekg(0, std::ios::end)) {
+            in.clear();
+            return -1;
+        }
+        std::streamoff left = in.tellg() - at;
+        in.seekg(at);
+        return left;
+    }
+
+    template <class T>
+    void read(std::istream & in, std::vector<T> & values, uint64_t size) {
+        values.resize(size);
+        if (!in.read(reinterpret_cast<char *>(values.data()), size * sizeof(T))) {
+            throw std::invalid_argument("The index is cut short");
+        }
+    }
+}
+
+inline void ContractionHierarchy::save(std::ostream & out) const {
+    uint64_t header[5] = {FORMAT, m_rank.size(), m_up.targets.size(), m_down.targets.size(), m_shortcuts};
+    out.write("CHIX", 4);
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    std::vector<int64_t> ranks(m_rank.begin(), m_rank.end());
+    detail::write(out, ranks);
+    for (const ShortcutGraph * graph : {&m_up, &m_down}) {
+        std::vector<uint64_t> offsets(graph->offsets.begin(), graph->offsets.end());
+        std::vector<int64_t> targets(graph->targets.begin(), graph->targets.end());
+        detail::write(out, offsets);
+        detail::write(out, targets);
+        detail::write(out, graph->weights);
+    }
+}
+
+// The integers are read as they were written, the index moves between
+// little endian machines only.
+inline ContractionHierarchy ContractionHierarchy::load(std::istream & in) {
+    char magic[4];
+    uint64_t header[5];
+    if (!in.read(magic, 4) || std::string(magic, 4) != "CHIX") throw std::invalid_argument("Not a contraction hierarchy index");
+    if (!in.read(reinterpret_cast<char *>(header), sizeof(header))) throw std::invalid_argument("The index is cut short");
+    if (header[0] != FORMAT) throw std::invalid_argument("Unknown version of the index");
+
+    // sizes from the header are checked before anything is allocated for them
+    uint64_t N = header[1];
+    const uint64_t LIMIT = std::numeric_limits<int>::max();
+    if (N > LIMIT || header[2] > LIMIT || header[3] > LIMIT) throw std::invalid_argument("Broken sizes in the index");
+    std::streamoff left = detail::remaining(in);
+    if (left != -1 && (uint64_t)left < 8 * (N + 2 * (N + 1) + 2 * (header[2] + header[3]))) {
+        throw std::invalid_argument("The index is cut short");
+    }
+
+    ContractionHierarchy index;
+    index.m_shortcuts = header[4];
+    std::vector<int64_t> ranks;
+    detail::read(in, ranks, N);
+    index.m_rank.assign(ranks.begin(), ranks.end());
+    ShortcutGraph * graphs[2] = {&index.m_up, &index.m_down};
+    for (int i = 0; i < 2; ++ i) {
+        uint64_t M = header[2 + i];
+        std::vector<uint64_t> offsets;
+        std::vector<int64_t> targets;
+        detail::read(in, offsets, N + 1);
+        detail::read(in, targets, M);
+        detail::read(in, graphs[i]->weights, M);
+        if (offsets[0] != 0 || offsets[N] != M || !std::is_sorted(offsets.begin(), offsets.end())) {
+            throw std::invalid_argument("Broken offsets in the index");
+        }
+        for (int64_t target : targets) {
+            if (target < 0 || (uint64_t)target >= N) throw std::invalid_argument("Broken edge in the index");
+        }
+        for (int64_t weight : graphs[i]->weights) {
+            if (weight < 0) throw std::invalid_argument("Negative weight in the index");
+        }
+        graphs[i]->offsets.assign(offsets.begin(), offsets.end());
+        graphs[i]->targets.assign(targets.begin(), targets.end());
+    }
+    return index;
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <vector>
+#include <barrier>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <atomic>
+#include <queue>
+
+#include "graph.h"
+
+// Single source shortest paths by delta-stepping (Meyer and Sanders) on
+// several threads, the weights must not be negative. Nodes wait in buckets of
+// width delta by their tentative distance. The smallest nonempty bucket is
+// emptied in rounds: its nodes relax their light edges (weight <= delta),
+// which may put nodes back into it; once it stays empty, the nodes it had
+// relax their heavy edges, which only reach later buckets.
+// Node v belongs to thread v % threads, which alone keeps its distance, parent
+// and buckets. A round relaxes the edges of every thread's nodes into
+// per-thread request buffers, one for each owner, then after a barrier every
+// owner applies the requests for its nodes, so nothing needs atomics. The
+// completion step of the barrier decides what comes next, as in
+// ParallelPushRelabel.
+// Tentative distances in the buckets never run more than the largest weight
+// past the current bucket, so the buckets of a thread are a cyclic array of
+// largest / delta + 2 slots, bucket i in slot i % slots. The slots are
+// capped by the nodes of a thread, a slot may then hold later buckets too and
+// its nodes are checked for the bucket they are in. Every owner also keeps a
+// heap of the buckets it put nodes into, the next bucket is the smallest of
+// them still holding its node, so empty buckets are never walked and neither
+// memory nor time grows with the distances over delta.
+// Delta 0 takes the largest weight over the average degree.
+class DeltaStepping : public Graph {
+    public:
+        DeltaStepping(size_t N, long delta = 0, unsigned threads = std::thread::hardware_concurrency());
+        DeltaStepping(size_t N, std::vector<CSRGraph::Edge> edges, long delta = 0, unsigned threads = std::thread::hardware_concurrency());
+        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
+
+        void setDelta(long delta) { m_delta = delta; }
+        void setThreads(unsigned threads) { m_threads = std::max(1u, threads); }
+        // rounds of the last findPaths
+        size_t rounds() const { return m_rounds; }
+
+    private:
+        // state of one findPaths
+        struct Run;
+
+        long m_delta;
+        unsigned m_threads;
+        mutable std::atomic<size_t> m_rounds = 0;
+};
+
+struct DeltaStepping::Run {
+    struct Request {
+        int node, from;
+        long distance;
+    };
+
+    // runs on one thread between the steps of a round
+    struct RoundStep {
+        Run * run;
+        void operator()() noexcept { run->roundStep(); }
+    };
+
+    const CSRGraph & graph;
+    std::vector<long> & dist;
+    std::vector<int> & parent;
+    long delta;
+    unsigned threads;
+    size_t slots;
+
+    // buckets[t][i % slots]: nodes of thread t with distance in
+    // [i delta, (i + 1) delta), the node may have moved to a lower one since
+    std::vector<std::vector<std::vector<int>>> buckets;
+    // a thread put nodes back into the current bucket in the last round
+    std::vector<char> refilled;
+    // pending[t]: smallest first, the buckets thread t put a node into with
+    // the node, stale once the node moved on
+    using Pending = std::pair<size_t, int>;
+    std::vector<std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>>> pending;
+    // nodes of the current bucket a thread works on, all it had for the heavy edges
+    std::vector<std::vector<int>> frontier, settled;
+    // requests[t * threads + owner] from thread t for nodes of the owner
+    std::vector<std::vector<Request>> requests;
+    // distance a node last relaxed its light edges with, -1 before
+    std::vector<long> relaxed;
+
+    size_t bucket = 0;
+    bool heavy = false;
+    bool done = false;
+    int step = 0;
+    size_t rounds = 0;
+
+    Run(const CSRGraph & graph, std::vector<long> & dist, std::vector<int> & parent, long delta, unsigned threads, size_t slots)
+    : graph(graph), dist(dist), parent(parent), delta(delta), threads(threads), slots(slots)
+    , buckets(threads, std::vector<std::vector<int>>(slots)), refilled(threads, false), pending(threads)
+    , frontier(threads), settled(threads), requests(threads * threads), relaxed(graph.size(), -1)
+    {
+    }
+
+    void solve(int start) {
+        dist[start] = 0;
+        buckets[start % threads][0].push_back(start);
+
+        std::barrier<RoundStep> sync(threads, RoundStep{this});
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; ++ t) {
+            workers.emplace_back(&Run::worker, this, t, std::ref(sync));
+        }
+        worker(0, sync);
+        for (auto & thread : workers) thread.join();
+    }
+
+    void worker(unsigned thread, std::barrier<RoundStep> & sync) {
+        while (true) {
+            relax(thread);
+            sync.arrive_and_wait();
+            apply(thread);
+            sync.arrive_and_wait();
+            if (done) break;
+        }
+    }
+
+    // Light edges of the nodes in the current bucket or heavy edges of all
+    // it had, a node whose distance moved it to a lower bucket went through
+    // that already.
+    void relax(unsigned thread) {
+        auto request = [&](int from, bool light) {
+            for (size_t i = graph.offsets[from]; i < graph.offsets[from + 1]; ++ i) {
+                if ((graph.weights[i] <= delta) != light) continue;
+                int node = graph.targets[i];
+                requests[thread * threads + node % threads].push_back({node, from, dist[from] + graph.weights[i]});
+            }
+        };
+        if (heavy) {
+            for (int node : settled[thread]) request(node, false);
+            settled[thread].clear();
+            return;
+        }
+
+        frontier[thread].clear();
+        std::vector<int> & slot = buckets[thread][bucket % slots];
+        std::swap(frontier[thread], slot);
+        for (int node : frontier[thread]) {
+            size_t i = dist[node] / delta;
+            // a later bucket of the same slot keeps its node
+            if (i > bucket && i % slots == bucket % slots) slot.push_back(node);
+            if (i != bucket || relaxed[node] == dist[node]) continue;
+            if (relaxed[node] == -1) settled[thread].push_back(node);
+            relaxed[node] = dist[node];
+            request(node, true);
+        }
+    }
+
+    void apply(unsigned owner) {
+        auto & mine = buckets[owner];
+        for (unsigned t = 0; t < threads; ++ t) {
+            for (const Request & request : requests[t * threads + owner]) {
+                if (request.distance >= dist[request.node]) continue;
+                dist[request.node] = request.distance;
+                parent[request.node] = request.from;
+                size_t i = request.distance / delta;
+                mine[i % slots].push_back(request.node);
+                if (i == bucket) refilled[owner] = true;
+                else pending[owner].push({i, request.node});
+            }
+            requests[t * threads + owner].clear();
+        }
+    }
+
+    void roundStep() noexcept {
+        if (++ step % 2 != 0) return;
+        ++ rounds;
+
+        if (!heavy) {
+            // the heavy edges once the bucket stays empty
+            heavy = std::find(refilled.begin(), refilled.end(), true) == refilled.end();
+            std::fill(refilled.begin(), refilled.end(), false);
+            return;
+        }
+
+        heavy = false;
+        bucket = next();
+        done = bucket == NONE;
+    }
+
+    static constexpr size_t NONE = -1;
+
+    // The smallest bucket after the current one with a node in it, NONE if
+    // there is none. Every entry of the heaps is popped once.
+    size_t next() {
+        size_t best = NONE;
+        for (auto & heap : pending) {
+            while (!heap.empty()) {
+                auto [i, node] = heap.top();
+                if (i > bucket && (size_t)(dist[node] / delta) == i) break;
+                heap.pop();
+            }
+            if (!heap.empty()) best = std::min(best, heap.top().first);
+        }
+        return best;
+    }
+};
+
+inline DeltaStepping::DeltaStepping(size_t N, long delta, unsigned threads)
+: Graph(N)
+, m_delta(delta)
+, m_threads(std::max(1u, threads))
+{
+}
+
+inline DeltaStepping::DeltaStepping(size_t N, std::vector<CSRGraph::Edge> edges, long delta, unsigned threads)
+: Graph(N, std::move(edges))
+, m_delta(delta)
+, m_threads(std::max(1u, threads))
+{
+}
+
+inline void DeltaStepping::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
+    const CSRGraph & graph = adjacency();
+    size_t const N = graph.size();
+    dist.assign(N, INF);
+    parent.assign(N, -1);
+
+    if (graph.smallest < 0) throw std::invalid_argument("Negative weights are not allowed");
+    long largest = graph.largest;
+    long delta = m_delta;
+    if (delta <= 0) delta = std::max(1L, (long)(largest * N / std::max<size_t>(1, graph.targets.size())));
+    size_t slots = std::min<size_t>(largest / delta + 2, N / m_threads + 2);
+
+    Run run(graph, dist, parent, delta, m_threads, slots);
+    run.solve(start);
+    m_rounds = run.rounds;
+}
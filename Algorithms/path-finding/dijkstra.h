@@ -0,0 +1,335 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+#include "graph.h"
+#include "../min-cost-max-flow/radix-heap.h"
+
+// Priority queues of nodes by distance for BasicDijkstra. reset(N) empties the
+// queue for nodes 0 .. N-1, clear() empties it in time of what is left in it,
+// push(node, key) inserts the node or lowers its key and pop() returns the
+// smallest key with its node. A lazy queue keeps the old
+// entries of a node whose key was lowered, Dijkstra skips an entry whose key
+// is not the distance of its node any more.
+
+// Binary heap of std::priority_queue, a push for every improvement, O(E) entries.
+class LazyBinaryHeap {
+    public:
+        void reset(size_t) { clear(); }
+        void clear() { m_heap = {}; }
+        bool empty() const { return m_heap.empty(); }
+        void push(int node, long key) { m_heap.push({key, node}); }
+
+        std::pair<long, int> pop() {
+            auto top = m_heap.top();
+            m_heap.pop();
+            return top;
+        }
+
+    private:
+        std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>, std::greater<std::pair<long, int>>> m_heap;
+};
+
+// Indexed 4-ary heap with decrease-key, every node is in it at most once.
+// Entries hold their keys, the four children of an entry fill one cache line
+// and the heap is half as deep as a binary one.
+class QuaternaryHeap {
+    public:
+        void reset(size_t N) {
+            m_heap.clear();
+            m_position.assign(N, -1);
+        }
+
+        void clear() {
+            for (const Entry & entry : m_heap) m_position[entry.node] = -1;
+            m_heap.clear();
+        }
+
+        bool empty() const { return m_heap.empty(); }
+
+        void push(int node, long key) {
+            if (m_position[node] == -1) {
+                m_position[node] = m_heap.size();
+                m_heap.push_back({key, node});
+            }
+            siftUp(m_position[node], {key, node});
+        }
+
+        std::pair<long, int> pop() {
+            Entry top = m_heap[0];
+            m_position[top.node] = -1;
+            Entry last = m_heap.back();
+            m_heap.pop_back();
+            if (!m_heap.empty()) siftDown(0, last);
+            return {top.key, top.node};
+        }
+
+    private:
+        struct Entry {
+            long key;
+            int node;
+        };
+
+        void siftUp(size_t i, Entry entry) {
+            while (i > 0) {
+                size_t parent = (i - 1) / 4;
+                if (m_heap[parent].key <= entry.key) break;
+                place(i, m_heap[parent]);
+                i = parent;
+            }
+            place(i, entry);
+        }
+
+        void siftDown(size_t i, Entry entry) {
+            size_t size = m_heap.size();
+            while (true) {
+                size_t first = 4 * i + 1;
+                if (first >= size) break;
+                size_t best = first;
+                size_t end = std::min(first + 4, size);
+                for (size_t child = first + 1; child < end; ++ child) {
+                    if (m_heap[child].key < m_heap[best].key) best = child;
+                }
+                if (m_heap[best].key >= entry.key) break;
+                place(i, m_heap[best]);
+                i = best;
+            }
+            place(i, entry);
+        }
+
+        void place(size_t i, Entry entry) {
+            m_heap[i] = entry;
+            m_position[entry.node] = i;
+        }
+
+        std::vector<Entry> m_heap;
+        std::vector<int> m_position;
+};
+
+// Monotone radix heap, lazy; Dijkstra with non-negative integer weights never
+// pushes a key below the last popped one.
+class RadixQueue {
+    public:
+        void reset(size_t) { clear(); }
+        void clear() { m_heap.clear(); }
+        bool empty() const { return m_heap.empty(); }
+        void push(int node, long key) { m_heap.push(key, node); }
+
+        std::pair<long, int> pop() {
+            auto [key, node] = m_heap.pop();
+            return {(long)key, node};
+        }
+
+    private:
+        RadixHeap<int> m_heap;
+};
+
+// Dijkstra with the priority queue as a template parameter, the weights must
+// not be negative: the searches throw std::invalid_argument otherwise, checked
+// once by the smallest weight of the frozen graph.
+// A point to point query searches only as far as it has to. Its distances,
+// parents and queue live across the queries and a node counts as untouched
+// unless its stamp is the number of the current query, so a query which
+// settles a few nodes does not pay for all N of them. One query runs at a
+// time on a graph.
+template <class Queue>
+class BasicDijkstra : public Graph {
+    public:
+        using Graph::Graph;
+        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
+
+        // Bidirectional: searches from the source and back from the target
+        // take turns until their smallest keys together reach the shortest
+        // path seen where they met. INF if there is no path.
+        long shortestPath(int source, int target) const;
+
+        // A*: the search from the source takes the node of the smallest
+        // distance + heuristic(node), which must not be more than the distance
+        // from the node to the target. The radix queue needs it consistent,
+        // heuristic(a) <= weight + heuristic(b) on every edge, as distances
+        // as the crow flies and landmark bounds are.
+        template <class Heuristic>
+        long shortestPath(int source, int target, Heuristic heuristic) const;
+
+        // nodes of the path of the last shortestPath, empty if there was none
+        std::vector<int> path() const;
+        // nodes the last shortestPath settled
+        size_t settled() const { return mSettled; }
+
+    private:
+        struct Search {
+            std::vector<long> dist;
+            std::vector<int> parent;
+            std::vector<unsigned> stamp;
+            Queue queue;
+        };
+
+        void startQuery() const;
+        void touch(Search & search, int node) const {
+            if (search.stamp[node] == mQuery) return;
+            search.stamp[node] = mQuery;
+            search.dist[node] = INF;
+            search.parent[node] = -1;
+        }
+
+        mutable Search mForward, mBackward;
+        // heuristic of the nodes touched by A*
+        mutable std::vector<long> mBound;
+        mutable unsigned mQuery = 0;
+        // the path goes from mMeetFrom back to the source by the forward
+        // parents and from mMeetTo to the target by the backward ones
+        mutable int mMeetFrom = -1, mMeetTo = -1;
+        mutable size_t mSettled = 0;
+};
+
+template <class Queue>
+void BasicDijkstra<Queue>::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
+    const CSRGraph & graph = adjacency();
+    if (graph.smallest < 0) throw std::invalid_argument("Negative weights are not allowed");
+    size_t const N = graph.size();
+    dist.assign(N, INF);
+    parent.assign(N, -1);
+    dist[start] = 0;
+    Queue queue;
+    queue.reset(N);
+    queue.push(start, 0);
+    while (!queue.empty()) {
+        auto [distance, current] = queue.pop();
+        if (distance != dist[current]) continue;
+
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            int next = graph.targets[i];
+            long weight = graph.weights[i];
+            if (dist[next] > dist[current] + weight) {
+                dist[next] = dist[current] + weight;
+                parent[next] = current;
+                queue.push(next, dist[next]);
+            }
+        }
+    }
+}
+
+template <class Queue>
+void BasicDijkstra<Queue>::startQuery() const {
+    if (adjacency().smallest < 0) throw std::invalid_argument("Negative weights are not allowed");
+    size_t N = adjacency().size();
+    for (Search * search : {&mForward, &mBackward}) {
+        if (search->stamp.size() != N) {
+            search->dist.resize(N);
+            search->parent.resize(N);
+            search->stamp.assign(N, 0);
+            search->queue.reset(N);
+        }
+        search->queue.clear();
+    }
+    if (++ mQuery == 0) {
+        // the stamps wrapped around, every node becomes untouched again
+        std::fill(mForward.stamp.begin(), mForward.stamp.end(), 0);
+        std::fill(mBackward.stamp.begin(), mBackward.stamp.end(), 0);
+        mQuery = 1;
+    }
+    mMeetFrom = mMeetTo = -1;
+    mSettled = 0;
+}
+
+template <class Queue>
+long BasicDijkstra<Queue>::shortestPath(int source, int target) const {
+    const CSRGraph * graphs[2] = {&adjacency(), &reverseAdjacency()};
+    Search * searches[2] = {&mForward, &mBackward};
+    startQuery();
+    touch(mForward, source);
+    mForward.dist[source] = 0;
+    mForward.queue.push(source, 0);
+    touch(mBackward, target);
+    mBackward.dist[target] = 0;
+    mBackward.queue.push(target, 0);
+
+    long best = INF;
+    if (source == target) {
+        best = 0;
+        mMeetTo = target;
+    }
+    long last[2] = {0, 0};
+    for (int side = 0; !mForward.queue.empty() && !mBackward.queue.empty(); side ^= 1) {
+        Search & search = *searches[side];
+        const Search & other = *searches[side ^ 1];
+        const CSRGraph & graph = *graphs[side];
+        auto [distance, current] = search.queue.pop();
+        if (distance != search.dist[current]) continue;
+        last[side] = distance;
+        if (last[0] + last[1] >= best) break;
+        ++ mSettled;
+
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            int next = graph.targets[i];
+            long weight = graph.weights[i];
+            touch(search, next);
+            if (search.dist[next] > distance + weight) {
+                search.dist[next] = distance + weight;
+                search.parent[next] = current;
+                search.queue.push(next, search.dist[next]);
+            }
+            if (other.stamp[next] == mQuery && other.dist[next] != INF && distance + weight + other.dist[next] < best) {
+                best = distance + weight + other.dist[next];
+                // the edge goes from current to next, backwards from next to current
+                mMeetFrom = side == 0 ? current : next;
+                mMeetTo = side == 0 ? next : current;
+            }
+        }
+    }
+    return best;
+}
+
+template <class Queue>
+template <class Heuristic>
+long BasicDijkstra<Queue>::shortestPath(int source, int target, Heuristic heuristic) const {
+    const CSRGraph & graph = adjacency();
+    startQuery();
+    mBound.resize(graph.size());
+    Search & search = mForward;
+    touch(search, source);
+    mBound[source] = heuristic(source);
+    search.dist[source] = 0;
+    search.queue.push(source, mBound[source]);
+    while (!search.queue.empty()) {
+        auto [key, current] = search.queue.pop();
+        if (key != search.dist[current] + mBound[current]) continue;
+        ++ mSettled;
+        if (current == target) {
+            mMeetFrom = target;
+            return search.dist[target];
+        }
+
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            int next = graph.targets[i];
+            long weight = graph.weights[i];
+            if (search.stamp[next] != mQuery) {
+                touch(search, next);
+                mBound[next] = heuristic(next);
+            }
+            if (search.dist[next] > search.dist[current] + weight) {
+                search.dist[next] = search.dist[current] + weight;
+                search.parent[next] = current;
+                search.queue.push(next, search.dist[next] + mBound[next]);
+            }
+        }
+    }
+    return INF;
+}
+
+template <class Queue>
+std::vector<int> BasicDijkstra<Queue>::path() const {
+    std::vector<int> nodes;
+    for (int v = mMeetFrom; v != -1; v = mForward.parent[v]) nodes.push_back(v);
+    std::reverse(nodes.begin(), nodes.end());
+    for (int v = mMeetTo; v != -1; v = mBackward.parent[v]) nodes.push_back(v);
+    return nodes;
+}
+
+// the radix heap is the fastest on road graphs, see benchmark.cpp
+using Dijkstra = BasicDijkstra<RadixQueue>;
@@ -1,13 +1,169 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
 
+// Adjacency of a directed graph in compressed sparse row form: the edges out
+// of node u are targets[offsets[u] .. offsets[u + 1]) with their weights
+// alongside. It is built once from an edge list by a counting sort which keeps
+// the order of the edges out of a node, three allocations for the whole graph.
+// Weights are 32 bits in the graphs of the searches, an index whose shortcut
+// weights add up takes 64 bits.
+template <class Weight>
+struct BasicCSRGraph {
+    struct Edge {
+        int from, to;
+        Weight weight;
+    };
+
+    BasicCSRGraph() = default;
+    BasicCSRGraph(size_t N, const std::vector<Edge> & edges);
+    size_t size() const { return offsets.size() - 1; }
+    // the same edges turned around
+    BasicCSRGraph reversed() const;
+
+    std::vector<size_t> offsets;
+    std::vector<int> targets;
+    std::vector<Weight> weights;
+    // smallest and largest weight, 0 without edges
+    Weight smallest = 0, largest = 0;
+};
+
+template <class Weight>
+inline BasicCSRGraph<Weight>::BasicCSRGraph(size_t N, const std::vector<Edge> & edges)
+: offsets(N + 1, 0)
+, targets(edges.size())
+, weights(edges.size())
+{
+    if (!edges.empty()) smallest = largest = edges[0].weight;
+    for (const Edge & edge : edges) ++ offsets[edge.from + 1];
+    for (size_t u = 0; u < N; ++ u) offsets[u + 1] += offsets[u];
+    // offsets[u] runs over the edges of u - 1 and ends at its start again
+    for (const Edge & edge : edges) {
+        size_t i = offsets[edge.from] ++;
+        targets[i] = edge.to;
+        weights[i] = edge.weight;
+        smallest = std::min(smallest, edge.weight);
+        largest = std::max(largest, edge.weight);
+    }
+    for (size_t u = N; u > 0; -- u) offsets[u] = offsets[u - 1];
+    offsets[0] = 0;
+}
+
+template <class Weight>
+inline BasicCSRGraph<Weight> BasicCSRGraph<Weight>::reversed() const {
+    size_t N = size();
+    BasicCSRGraph reverse;
+    reverse.offsets.assign(N + 1, 0);
+    reverse.targets.resize(targets.size());
+    reverse.weights.resize(weights.size());
+    reverse.smallest = smallest;
+    reverse.largest = largest;
+    for (int v : targets) ++ reverse.offsets[v + 1];
+    for (size_t v = 0; v < N; ++ v) reverse.offsets[v + 1] += reverse.offsets[v];
+    for (size_t u = 0; u < N; ++ u) {
+        for (size_t i = offsets[u]; i < offsets[u + 1]; ++ i) {
+            size_t j = reverse.offsets[targets[i]] ++;
+            reverse.targets[j] = u;
+            reverse.weights[j] = weights[i];
+        }
+    }
+    for (size_t v = N; v > 0; -- v) reverse.offsets[v] = reverse.offsets[v - 1];
+    reverse.offsets[0] = 0;
+    return reverse;
+}
+
+using CSRGraph = BasicCSRGraph<int32_t>;
+
+// Edges are collected by addEdge and frozen into the CSRGraph on the first
+// search, another addEdge thaws them. The const searches may run on several
+// threads at once: the first of them freezes the edges under a lock, the
+// others wait for it and then share the CSRGraph. addEdge must not run
+// alongside a search.
 class Graph {
     public:
+        Graph(size_t N) : mNodes(N) {}
+        Graph(size_t N, std::vector<CSRGraph::Edge> edges);
+        virtual ~Graph() = default;
 
-        virtual bool addEdge(int a, int b, int weight) = 0; 
+        virtual bool addEdge(int a, int b, int weight);
         virtual void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const = 0;
-        
+
         inline static long INF = 1e18;
 
+    protected:
+        const CSRGraph & adjacency() const;
+        // built on its first use as well, for searches towards a target
+        const CSRGraph & reverseAdjacency() const;
+
+    private:
+        size_t mNodes;
+        mutable std::vector<CSRGraph::Edge> mEdges;
+        mutable std::mutex mFreezing;
+        mutable CSRGraph mFrozen;
+        mutable std::atomic<bool> mIsFrozen = false;
+        mutable CSRGraph mReverse;
+        mutable std::atomic<bool> mHasReverse = false;
 };
+
+// throws when a node is out of range, as addEdge refuses it
+inline Graph::Graph(size_t N, std::vector<CSRGraph::Edge> edges)
+: mNodes(N)
+, mEdges(std::move(edges))
+{
+    for (const CSRGraph::Edge & edge : mEdges) {
+        if (edge.from < 0 || edge.to < 0 || (size_t)edge.from >= N || (size_t)edge.to >= N) {
+            throw std::invalid_argument("Node of an edge out of range");
+        }
+    }
+}
+
+// false when a node is out of range
+inline bool Graph::addEdge(int a, int b, int weight) {
+    if (a < 0 || b < 0 || (size_t)a >= mNodes || (size_t)b >= mNodes) return false;
+    if (mIsFrozen) {
+        for (size_t u = 0; u < mNodes; ++ u) {
+            for (size_t i = mFrozen.offsets[u]; i < mFrozen.offsets[u + 1]; ++ i) {
+                mEdges.push_back({(int)u, mFrozen.targets[i], mFrozen.weights[i]});
+            }
+        }
+        mFrozen = CSRGraph();
+        mIsFrozen = false;
+        mReverse = CSRGraph();
+        mHasReverse = false;
+    }
+    mEdges.push_back({a, b, weight});
+    return true;
+}
+
+// Once frozen the flag is all a search reads, the lock is only taken while
+// the CSRGraph may still be built.
+inline const CSRGraph & Graph::adjacency() const {
+    if (!mIsFrozen.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mFreezing);
+        if (!mIsFrozen.load(std::memory_order_relaxed)) {
+            mFrozen = CSRGraph(mNodes, mEdges);
+            // the edge list is not needed any more
+            std::vector<CSRGraph::Edge>().swap(mEdges);
+            mIsFrozen.store(true, std::memory_order_release);
+        }
+    }
+    return mFrozen;
+}
+
+inline const CSRGraph & Graph::reverseAdjacency() const {
+    const CSRGraph & forward = adjacency();
+    if (!mHasReverse.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mFreezing);
+        if (!mHasReverse.load(std::memory_order_relaxed)) {
+            mReverse = forward.reversed();
+            mHasReverse.store(true, std::memory_order_release);
+        }
+    }
+    return mReverse;
+}
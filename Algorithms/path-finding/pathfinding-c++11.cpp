@@ -4,17 +4,118 @@
 #include <iomanip>
 
 #include <vector>
+#include <cstdint>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+// Adjacency of a directed graph in compressed sparse row form: the edges out
+// of node u are targets[offsets[u] .. offsets[u + 1]) with their weights
+// alongside. It is built once from an edge list by a counting sort which keeps
+// the order of the edges out of a node, three allocations for the whole graph.
+struct CSRGraph {
+    struct Edge {
+        int from, to;
+        int32_t weight;
+    };
+
+    CSRGraph() = default;
+    CSRGraph(size_t N, const std::vector<Edge> & edges);
+    size_t size() const { return offsets.size() - 1; }
+
+    std::vector<size_t> offsets;
+    std::vector<int> targets;
+    std::vector<int32_t> weights;
+};
+
+inline CSRGraph::CSRGraph(size_t N, const std::vector<Edge> & edges)
+: offsets(N + 1, 0)
+, targets(edges.size())
+, weights(edges.size())
+{
+    for (const Edge & edge : edges) ++ offsets[edge.from + 1];
+    for (size_t u = 0; u < N; ++ u) offsets[u + 1] += offsets[u];
+    // offsets[u] runs over the edges of u - 1 and ends at its start again
+    for (const Edge & edge : edges) {
+        size_t i = offsets[edge.from] ++;
+        targets[i] = edge.to;
+        weights[i] = edge.weight;
+    }
+    for (size_t u = N; u > 0; -- u) offsets[u] = offsets[u - 1];
+    offsets[0] = 0;
+}
 
+// Edges are collected by addEdge and frozen into the CSRGraph on the first
+// search, another addEdge thaws them. The const searches may run on several
+// threads at once: the first of them freezes the edges under a lock, the
+// others wait for it and then share the CSRGraph. addEdge must not run
+// alongside a search.
 class Graph {
     public:
+        Graph(size_t N) : mNodes(N) {}
+        Graph(size_t N, std::vector<CSRGraph::Edge> edges);
+        virtual ~Graph() = default;
 
-        virtual bool addEdge(int a, int b, int weight) = 0; 
+        virtual bool addEdge(int a, int b, int weight);
         virtual void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const = 0;
-        
+
         static long INF;
 
+    protected:
+        const CSRGraph & adjacency() const;
+
+    private:
+        size_t mNodes;
+        mutable std::vector<CSRGraph::Edge> mEdges;
+        mutable std::mutex mFreezing;
+        mutable CSRGraph mFrozen;
+        mutable std::atomic<bool> mIsFrozen{false};
 };
 
+// throws when a node is out of range, as addEdge refuses it
+inline Graph::Graph(size_t N, std::vector<CSRGraph::Edge> edges)
+: mNodes(N)
+, mEdges(std::move(edges))
+{
+    for (const CSRGraph::Edge & edge : mEdges) {
+        if (edge.from < 0 || edge.to < 0 || (size_t)edge.from >= N || (size_t)edge.to >= N) {
+            throw std::invalid_argument("Node of an edge out of range");
+        }
+    }
+}
+
+// false when a node is out of range
+inline bool Graph::addEdge(int a, int b, int weight) {
+    if (a < 0 || b < 0 || (size_t)a >= mNodes || (size_t)b >= mNodes) return false;
+    if (mIsFrozen) {
+        for (size_t u = 0; u < mNodes; ++ u) {
+            for (size_t i = mFrozen.offsets[u]; i < mFrozen.offsets[u + 1]; ++ i) {
+                mEdges.push_back({(int)u, mFrozen.targets[i], mFrozen.weights[i]});
+            }
+        }
+        mFrozen = CSRGraph();
+        mIsFrozen = false;
+    }
+    mEdges.push_back({a, b, weight});
+    return true;
+}
+
+// Once frozen the flag is all a search reads, the lock is only taken while
+// the CSRGraph may still be built.
+inline const CSRGraph & Graph::adjacency() const {
+    if (!mIsFrozen.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mFreezing);
+        if (!mIsFrozen.load(std::memory_order_relaxed)) {
+            mFrozen = CSRGraph(mNodes, mEdges);
+            // the edge list is not needed any more
+            std::vector<CSRGraph::Edge>().swap(mEdges);
+            mIsFrozen.store(true, std::memory_order_release);
+        }
+    }
+    return mFrozen;
+}
+
 long Graph::INF =  1e18;
 
 #include <cassert>
@@ -113,29 +214,48 @@ void zero_sum_cycle_test() {
     }
 }
 
+template <class GraphType>
+void edge_list_test() {
+    static_assert(std::is_base_of<Graph, GraphType>::value == true, "GraphType needs to be derived from Graph");
+    std::vector<CSRGraph::Edge> edges = {{0, 1, 5}, {1, 2, 5}, {0, 2, 20}, {2, 3, 1}};
+    GraphType graph(5, edges);
+    assert(!graph.addEdge(0, 5, 1));
 
+    std::vector<long> dist;
+    std::vector<int> parent;
+    graph.findPaths(0, dist, parent);
+    assert(dist[2] == 10 && parent[2] == 1);
+    assert(dist[3] == 11 && dist[4] == Graph::INF);
 
+    // an edge after the search joins the frozen ones
+    assert(graph.addEdge(0, 3, 3));
+    assert(graph.addEdge(3, 4, 1));
+    graph.findPaths(0, dist, parent);
+    assert(dist[2] == 10 && parent[2] == 1);
+    assert(dist[3] == 3 && parent[3] == 0);
+    assert(dist[4] == 4 && parent[4] == 3);
 
-class BellmanFord : public Graph {
-    public:
-        BellmanFord (size_t N);
-        bool addEdge(int a, int b, int weight) override; 
-        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
+    // the edge list is checked as addEdge is
+    try {
+        GraphType outside(3, {{0, 3, 1}});
+        assert("Exception should be thrown" == nullptr);
+    } catch (const std::invalid_argument &) {
+    }
+}
 
-    private:
 
-        std::vector<std::vector<std::pair<int,long>>> mAdjacent;
-};
 
-BellmanFord::BellmanFord(size_t N): mAdjacent(N) {}
 
-bool BellmanFord::addEdge(int a, int b, int weight) {
-    mAdjacent[a].push_back({b, weight});
-    return true;
-}
+
+class BellmanFord : public Graph {
+    public:
+        using Graph::Graph;
+        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
+};
 
 void BellmanFord::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
-    size_t const N = mAdjacent.size();
+    const CSRGraph & graph = adjacency();
+    size_t const N = graph.size();
     dist.assign(N, INF);
     parent.assign(N, -1);
     dist[start] = 0;
@@ -146,9 +266,9 @@ void BellmanFord::findPaths(int start, std::vector<long> & dist, std::vector<int
         }
         change = false;
         for (size_t u = 0; u < N; ++ u) {
-            for (auto x : mAdjacent[u]) {
-                auto v = x.first;
-                auto weight = x.second;
+            for (size_t i = graph.offsets[u]; i < graph.offsets[u + 1]; ++ i) {
+                int v = graph.targets[i];
+                long weight = graph.weights[i];
                 if (dist[u] != INF && dist[v] > dist[u] + weight) {
                     dist[v] = dist[u] + weight;
                     parent[v] = u;
@@ -164,24 +284,13 @@ void BellmanFord::findPaths(int start, std::vector<long> & dist, std::vector<int
 #include <queue>
 class Dijkstra : public Graph {
     public:
-        Dijkstra (size_t N);
-        bool addEdge(int a, int b, int weight) override; 
+        using Graph::Graph;
         void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
-
-    private:
-
-        std::vector<std::vector<std::pair<int,long>>> mAdjacent;
 };
 
-Dijkstra::Dijkstra(size_t N): mAdjacent(N) {}
-
-bool Dijkstra::addEdge(int a, int b, int weight) {
-    mAdjacent[a].push_back({b, weight});
-    return true;
-}
-
 void Dijkstra::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
-    size_t const N = mAdjacent.size();
+    const CSRGraph & graph = adjacency();
+    size_t const N = graph.size();
     dist.assign(N, INF);
     parent.assign(N, -1);
     dist[start] = 0;
@@ -198,9 +307,9 @@ void Dijkstra::findPaths(int start, std::vector<long> & dist, std::vector<int> &
         if (visited[current]) continue;
         visited[current] = true;
 
-        for (auto x : mAdjacent[current]) {
-            int next = x.first;
-            long weight = x.second;
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            int next = graph.targets[i];
+            long weight = graph.weights[i];
             if (dist[next] > dist[current] + weight) {
                 dist[next] = dist[current] + weight;
                 parent[next] = current;
@@ -214,24 +323,13 @@ void Dijkstra::findPaths(int start, std::vector<long> & dist, std::vector<int> &
 /// @brief Shortest Path Fast Algorithm improved Bellman-Ford
 class SPFA : public Graph {
     public:
-        SPFA (size_t N);
-        bool addEdge(int a, int b, int weight) override; 
+        using Graph::Graph;
         void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
-
-    private:
-
-        std::vector<std::vector<std::pair<int,long>>> mAdjacent;
 };
 
-SPFA::SPFA(size_t N): mAdjacent(N) {}
-
-bool SPFA::addEdge(int a, int b, int weight) {
-    mAdjacent[a].push_back({b, weight});
-    return true;
-}
-
 void SPFA::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
-    size_t const N = mAdjacent.size();
+    const CSRGraph & graph = adjacency();
+    size_t const N = graph.size();
     dist.assign(N, INF);
     parent.assign(N, -1);
     std::vector<bool> inqueue(N, false);
@@ -245,9 +343,9 @@ void SPFA::findPaths(int start, std::vector<long> & dist, std::vector<int> & par
         queue.pop_front();        
         inqueue[current] = false;
 
-        for (auto edge : mAdjacent[current]) {
-            auto next = edge.first;
-            auto weight = edge.second;
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            int next = graph.targets[i];
+            long weight = graph.weights[i];
             if (dist[next] > dist[current] + weight) {
                 dist[next] = dist[current] + weight;
                 parent[next] = current;
@@ -268,8 +366,10 @@ void testing() {
     negative_edge_test<BellmanFord>();
     negative_cycle_test<BellmanFord>();
     zero_sum_cycle_test<BellmanFord>();
+    edge_list_test<BellmanFord>();
 
     basic_test<Dijkstra>();
+    edge_list_test<Dijkstra>();
     // negative_edge_test<Dijkstra>();
     // negative_cycle_test<Dijkstra>();
 
@@ -277,6 +377,7 @@ void testing() {
     negative_edge_test<SPFA>();
     negative_cycle_test<SPFA>();
     zero_sum_cycle_test<SPFA>();
+    edge_list_test<SPFA>();
 }
 
 int main () {
@@ -3,20 +3,15 @@
 #include <algorithm>
 #include <iomanip>
 
-#include <vector>
-
-class Graph {
-    public:
-
-        virtual bool addEdge(int a, int b, int weight) = 0; 
-        virtual void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const = 0;
-        
-        inline static long INF = 1e18;
-
-};
+#include "graph.h"
+#include "dijkstra.h"
+#include "delta-stepping.h"
 
 #include <cassert>
 #include <type_traits>
+#include <random>
+#include <cstdlib>
+#include <thread>
 
 template <class GraphType>
 void basic_test() {
@@ -111,29 +106,96 @@ void zero_sum_cycle_test() {
     }
 }
 
+template <class GraphType>
+void edge_list_test() {
+    static_assert(std::is_base_of<Graph, GraphType>::value == true);
+    std::vector<CSRGraph::Edge> edges = {{0, 1, 5}, {1, 2, 5}, {0, 2, 20}, {2, 3, 1}};
+    GraphType graph(5, edges);
+    assert(!graph.addEdge(0, 5, 1));
 
+    std::vector<long> dist;
+    std::vector<int> parent;
+    graph.findPaths(0, dist, parent);
+    assert(dist[2] == 10 && parent[2] == 1);
+    assert(dist[3] == 11 && dist[4] == Graph::INF);
 
+    // an edge after the search joins the frozen ones
+    assert(graph.addEdge(0, 3, 3));
+    assert(graph.addEdge(3, 4, 1));
+    graph.findPaths(0, dist, parent);
+    assert(dist[2] == 10 && parent[2] == 1);
+    assert(dist[3] == 3 && parent[3] == 0);
+    assert(dist[4] == 4 && parent[4] == 3);
 
-class BellmanFord : public Graph {
-    public:
-        BellmanFord (size_t N);
-        bool addEdge(int a, int b, int weight) override; 
-        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
+    // the edge list is checked as addEdge is
+    try {
+        GraphType outside(3, {{0, 3, 1}});
+        assert("Exception should be thrown" == nullptr);
+    } catch (const std::invalid_argument &) {
+    }
+}
 
-    private:
+// Negative weights throw instead of looping around a negative cycle, in the
+// full search and in the point to point ones.
+template <class GraphType>
+void negative_weight_test() {
+    GraphType graph(5, {{0, 1, 1}, {1, 2, -1}, {2, 3, -1}, {3, 1, -1}, {3, 4, 1}});
+    std::vector<long> dist;
+    std::vector<int> parent;
+    auto throws = [](auto search) {
+        try {
+            search();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    assert(throws([&]() { graph.findPaths(0, dist, parent); }));
+    assert(throws([&]() { graph.shortestPath(0, 4); }));
+    assert(throws([&]() { graph.shortestPath(0, 4, [](int) { return 0L; }); }));
+
+    // a single negative edge off any cycle as well
+    GraphType acyclic(3, {{0, 1, 2}, {1, 2, -1}});
+    assert(throws([&]() { acyclic.findPaths(0, dist, parent); }));
+}
 
-        std::vector<std::vector<std::pair<int,long>>> mAdjacent;
-};
+// Searches on several threads at once freeze a fresh graph only once.
+void concurrent_freeze_test() {
+    std::mt19937 random(12);
+    int N = 2000;
+    std::vector<CSRGraph::Edge> edges;
+    for (int i = 0; i < 8 * N; ++ i) edges.push_back({(int)(random() % N), (int)(random() % N), (int)(random() % 100)});
+    Dijkstra expected(N, edges);
+    std::vector<long> dist;
+    std::vector<int> parent;
+    expected.findPaths(0, dist, parent);
+
+    Dijkstra graph(N, edges);
+    std::vector<std::vector<long>> found(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++ t) {
+        threads.emplace_back([&, t]() {
+            std::vector<int> parent;
+            graph.findPaths(0, found[t], parent);
+        });
+    }
+    for (auto & thread : threads) thread.join();
+    for (const auto & distances : found) assert(distances == dist);
+}
 
-BellmanFord::BellmanFord(size_t N): mAdjacent(N) {}
 
-bool BellmanFord::addEdge(int a, int b, int weight) {
-    mAdjacent[a].push_back({b, weight});
-    return true;
-}
+
+
+
+class BellmanFord : public Graph {
+    public:
+        using Graph::Graph;
+        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
+};
 
 void BellmanFord::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
-    size_t const N = mAdjacent.size();
+    const CSRGraph & graph = adjacency();
+    size_t const N = graph.size();
     dist.assign(N, INF);
     parent.assign(N, -1);
     dist[start] = 0;
@@ -144,7 +206,9 @@ void BellmanFord::findPaths(int start, std::vector<long> & dist, std::vector<int
         }
         change = false;
         for (size_t u = 0; u < N; ++ u) {
-            for (auto [v, weight] : mAdjacent[u]) {
+            for (size_t i = graph.offsets[u]; i < graph.offsets[u + 1]; ++ i) {
+                int v = graph.targets[i];
+                long weight = graph.weights[i];
                 if (dist[u] != INF && dist[v] > dist[u] + weight) {
                     dist[v] = dist[u] + weight;
                     parent[v] = u;
@@ -156,75 +220,182 @@ void BellmanFord::findPaths(int start, std::vector<long> & dist, std::vector<int
 }
 
 
-#include <queue>
-class Dijkstra : public Graph {
-    public:
-        Dijkstra (size_t N);
-        bool addEdge(int a, int b, int weight) override; 
-        void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
-
-    private:
+// Every queue gives the distances of Bellman-Ford on random non-negative weights.
+template <class GraphType>
+void random_test() {
+    static_assert(std::is_base_of<Graph, GraphType>::value == true);
+    std::mt19937 random(7);
+    for (int round = 0; round < 200; ++ round) {
+        int N = 1 + random() % 30, M = random() % 100;
+        GraphType graph(N);
+        BellmanFord reference(N);
+        for (int i = 0; i < M; ++ i) {
+            int a = random() % N, b = random() % N, weight = random() % 50;
+            graph.addEdge(a, b, weight);
+            reference.addEdge(a, b, weight);
+        }
+        std::vector<long> dist, expected;
+        std::vector<int> parent;
+        reference.findPaths(0, expected, parent);
+        graph.findPaths(0, dist, parent);
+        assert(dist == expected);
+        for (int v = 1; v < N; ++ v) {
+            assert((parent[v] == -1) == (dist[v] == Graph::INF));
+        }
+    }
+}
 
-        std::vector<std::vector<std::pair<int,long>>> mAdjacent;
-};
+// Length of the path, -1 if an edge of it is missing.
+long path_length(const std::vector<CSRGraph::Edge> & edges, const std::vector<int> & path) {
+    long length = 0;
+    for (size_t i = 1; i < path.size(); ++ i) {
+        long best = -1;
+        for (const auto & edge : edges) {
+            if (edge.from == path[i - 1] && edge.to == path[i] && (best == -1 || edge.weight < best)) best = edge.weight;
+        }
+        if (best == -1) return -1;
+        length += best;
+    }
+    return length;
+}
 
-Dijkstra::Dijkstra(size_t N): mAdjacent(N) {}
+// Queries one after another on the same graph against the full search, A*
+// on a grid where 10 per step as the crow flies is a consistent bound.
+template <class GraphType>
+void point_to_point_test() {
+    std::mt19937 random(8);
+    for (int round = 0; round < 100; ++ round) {
+        int N = 1 + random() % 40, M = random() % 120;
+        std::vector<CSRGraph::Edge> edges;
+        for (int i = 0; i < M; ++ i) edges.push_back({(int)(random() % N), (int)(random() % N), (int)(random() % 50)});
+        GraphType graph(N, edges);
+        std::vector<long> dist;
+        std::vector<int> parent;
+        for (int query = 0; query < 10; ++ query) {
+            int source = random() % N, target = random() % N;
+            graph.findPaths(source, dist, parent);
+            for (bool astar : {false, true}) {
+                long length = astar ? graph.shortestPath(source, target, [](int) { return 0L; }) : graph.shortestPath(source, target);
+                assert(length == dist[target]);
+                auto path = graph.path();
+                if (length == Graph::INF) {
+                    assert(path.empty());
+                    continue;
+                }
+                assert(path.front() == source && path.back() == target);
+                assert(path_length(edges, path) == length);
+            }
+        }
+    }
 
-bool Dijkstra::addEdge(int a, int b, int weight) {
-    mAdjacent[a].push_back({b, weight});
-    return true;
+    int side = 20;
+    std::vector<CSRGraph::Edge> edges;
+    for (int v = 0; v < side * side; ++ v) {
+        if (v % side + 1 < side) {
+            edges.push_back({v, v + 1, (int)(10 + random() % 20)});
+            edges.push_back({v + 1, v, (int)(10 + random() % 20)});
+        }
+        if (v + side < side * side) {
+            edges.push_back({v, v + side, (int)(10 + random() % 20)});
+            edges.push_back({v + side, v, (int)(10 + random() % 20)});
+        }
+    }
+    GraphType grid(side * side, edges);
+    std::vector<long> dist;
+    std::vector<int> parent;
+    for (int query = 0; query < 50; ++ query) {
+        int source = random() % (side * side), target = random() % (side * side);
+        auto crow = [&](int v) { return 10L * (std::abs(v % side - target % side) + std::abs(v / side - target / side)); };
+        grid.findPaths(source, dist, parent);
+        assert(grid.shortestPath(source, target, crow) == dist[target]);
+        assert(path_length(edges, grid.path()) == dist[target]);
+        assert(grid.settled() <= (size_t)(side * side));
+        assert(grid.shortestPath(source, target) == dist[target]);
+        assert(path_length(edges, grid.path()) == dist[target]);
+    }
 }
 
-void Dijkstra::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
-    size_t const N = mAdjacent.size();
-    dist.assign(N, INF);
-    parent.assign(N, -1);
-    dist[start] = 0;
-    std::priority_queue<
-        std::pair<long, int>,
-        std::vector<std::pair<long, int>>,
-        std::greater<std::pair<long, int>>> queue;
-    queue.push({0, start});
-    std::vector<bool> visited(N, false);
-    while (!queue.empty()) {
-        auto [distance, current] = queue.top();
-        queue.pop();
-        
-        if (visited[current]) continue;
-        visited[current] = true;
+// Every thread count and bucket width gives the distances of Dijkstra.
+void delta_stepping_test() {
+    std::mt19937 random(6);
+    for (int round = 0; round < 100; ++ round) {
+        int N = 1 + random() % 60, M = random() % 300;
+        std::vector<CSRGraph::Edge> edges;
+        for (int i = 0; i < M; ++ i) edges.push_back({(int)(random() % N), (int)(random() % N), (int)(random() % 100)});
+        Dijkstra reference(N, edges);
+        std::vector<long> expected, dist;
+        std::vector<int> parent;
+        int start = random() % N;
+        reference.findPaths(start, expected, parent);
+        for (unsigned threads : {1, 2, 4}) {
+            for (long delta : {0, 1, 7, 100, 1000}) {
+                DeltaStepping graph(N, edges, delta, threads);
+                graph.findPaths(start, dist, parent);
+                assert(dist == expected);
+                for (int v = 0; v < N; ++ v) {
+                    if (v == start || dist[v] == Graph::INF) {
+                        assert(parent[v] == -1);
+                        continue;
+                    }
+                    // the parent edge is on a shortest path
+                    bool found = false;
+                    for (const auto & edge : edges) {
+                        found |= edge.from == parent[v] && edge.to == v && dist[parent[v]] + edge.weight == dist[v];
+                    }
+                    assert(found);
+                }
+            }
+        }
+    }
 
-        for (auto [next, weight] : mAdjacent[current]) {
-            if (dist[next] > dist[current] + weight) {
-                dist[next] = dist[current] + weight;
-                parent[next] = current;
-                queue.push({dist[next], next});
+    // weights far above delta, the buckets wrap around their slots
+    for (int round = 0; round < 100; ++ round) {
+        int N = 1 + random() % 30, M = random() % 100;
+        std::vector<CSRGraph::Edge> edges;
+        for (int i = 0; i < M; ++ i) edges.push_back({(int)(random() % N), (int)(random() % N), (int)(random() % 2000000000)});
+        Dijkstra reference(N, edges);
+        std::vector<long> expected, dist;
+        std::vector<int> parent;
+        reference.findPaths(0, expected, parent);
+        for (unsigned threads : {1, 3}) {
+            for (long delta : {1, 1000, 100000000}) {
+                DeltaStepping graph(N, edges, delta, threads);
+                graph.findPaths(0, dist, parent);
+                assert(dist == expected);
             }
         }
     }
-}
+    // a long path of such weights at delta 1: two rounds a node, each finding
+    // the next bucket in no time, where walking the slots took quadratic time
+    int length = 100000;
+    std::vector<CSRGraph::Edge> path;
+    for (int v = 0; v + 1 < length; ++ v) path.push_back({v, v + 1, 2000000000});
+    DeltaStepping far(length, path, 1, 1);
+    std::vector<long> dist;
+    std::vector<int> parent;
+    far.findPaths(0, dist, parent);
+    assert(dist[length - 1] == 2000000000L * (length - 1) && far.rounds() <= 2 * (size_t)length);
 
+    DeltaStepping negative(2, {{0, 1, -1}});
+    try {
+        std::vector<long> dist;
+        std::vector<int> parent;
+        negative.findPaths(0, dist, parent);
+        assert("Exception should be thrown" == nullptr);
+    } catch (const std::invalid_argument &) {
+    }
+}
 
 /// @brief Shortest Path Fast Algorithm improved Bellman-Ford
 class SPFA : public Graph {
     public:
-        SPFA (size_t N);
-        bool addEdge(int a, int b, int weight) override; 
+        using Graph::Graph;
         void findPaths(int start, std::vector<long> & distance, std::vector<int> & parent) const override;
-
-    private:
-
-        std::vector<std::vector<std::pair<int,long>>> mAdjacent;
 };
 
-SPFA::SPFA(size_t N): mAdjacent(N) {}
-
-bool SPFA::addEdge(int a, int b, int weight) {
-    mAdjacent[a].push_back({b, weight});
-    return true;
-}
-
 void SPFA::findPaths(int start, std::vector<long> & dist, std::vector<int> & parent) const {
-    size_t const N = mAdjacent.size();
+    const CSRGraph & graph = adjacency();
+    size_t const N = graph.size();
     dist.assign(N, INF);
     parent.assign(N, -1);
     std::vector<bool> inqueue(N, false);
@@ -238,7 +409,9 @@ void SPFA::findPaths(int start, std::vector<long> & dist, std::vector<int> & par
         queue.pop_front();        
         inqueue[current] = false;
 
-        for (auto [next, weight] : mAdjacent[current]) {
+        for (size_t i = graph.offsets[current]; i < graph.offsets[current + 1]; ++ i) {
+            int next = graph.targets[i];
+            long weight = graph.weights[i];
             if (dist[next] > dist[current] + weight) {
                 dist[next] = dist[current] + weight;
                 parent[next] = current;
@@ -259,8 +432,29 @@ void testing() {
     negative_edge_test<BellmanFord>();
     negative_cycle_test<BellmanFord>();
     zero_sum_cycle_test<BellmanFord>();
+    edge_list_test<BellmanFord>();
 
     basic_test<Dijkstra>();
+    edge_list_test<Dijkstra>();
+    concurrent_freeze_test();
+    negative_weight_test<Dijkstra>();
+    negative_weight_test<BasicDijkstra<LazyBinaryHeap>>();
+    negative_weight_test<BasicDijkstra<QuaternaryHeap>>();
+    basic_test<BasicDijkstra<LazyBinaryHeap>>();
+    edge_list_test<BasicDijkstra<LazyBinaryHeap>>();
+    basic_test<BasicDijkstra<QuaternaryHeap>>();
+    edge_list_test<BasicDijkstra<QuaternaryHeap>>();
+    random_test<Dijkstra>();
+    random_test<BasicDijkstra<LazyBinaryHeap>>();
+    random_test<BasicDijkstra<QuaternaryHeap>>();
+    point_to_point_test<Dijkstra>();
+    point_to_point_test<BasicDijkstra<LazyBinaryHeap>>();
+    point_to_point_test<BasicDijkstra<QuaternaryHeap>>();
+
+    basic_test<DeltaStepping>();
+    edge_list_test<DeltaStepping>();
+    random_test<DeltaStepping>();
+    delta_stepping_test();
     // negative_edge_test<Dijkstra>();
     // negative_cycle_test<Dijkstra>();
 
@@ -268,6 +462,7 @@ void testing() {
     negative_edge_test<SPFA>();
     negative_cycle_test<SPFA>();
     zero_sum_cycle_test<SPFA>();
+    edge_list_test<SPFA>();
 }
 
 int main () {
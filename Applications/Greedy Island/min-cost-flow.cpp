@@ -1,14 +1,87 @@
 #include <vector>
 #include <deque>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <set>
 
-// Proper implementation
+// Monotone priority queue for Dijkstra with non-negative integer keys: no key
+// pushed may be smaller than the last one popped. Bucket i holds keys which
+// first differ from the last popped key in bit i - 1, when bucket 0 runs
+// empty the smallest nonempty bucket is redistributed into lower ones. Every
+// element moves down at most 64 times, O(log C) amortized per operation.
+template <class Value>
+class RadixHeap {
+    public:
+        void push(uint64_t key, Value value) {
+            m_buckets[bucket(key)].emplace_back(key, value);
+            ++ m_size;
+        }
+
+        // smallest key and its value
+        std::pair<uint64_t, Value> pop() {
+            if (m_buckets[0].empty()) refill();
+            auto top = m_buckets[0].back();
+            m_buckets[0].pop_back();
+            -- m_size;
+            return top;
+        }
+
+        bool empty() const { return m_size == 0; }
+
+        void clear() {
+            for (auto & bucket : m_buckets) bucket.clear();
+            m_last = 0;
+            m_size = 0;
+        }
+
+    private:
+        size_t bucket(uint64_t key) const {
+            return key == m_last ? 0 : 64 - std::countl_zero(key ^ m_last);
+        }
+
+        void refill() {
+            size_t i = 1;
+            while (m_buckets[i].empty()) ++ i;
+            uint64_t minimum = m_buckets[i][0].first;
+            for (const auto & [key, value] : m_buckets[i]) minimum = std::min(minimum, key);
+            m_last = minimum;
+            for (const auto & [key, value] : m_buckets[i]) {
+                m_buckets[bucket(key)].emplace_back(key, value);
+            }
+            m_buckets[i].clear();
+        }
+
+        std::array<std::vector<std::pair<uint64_t, Value>>, 65> m_buckets;
+        uint64_t m_last = 0;
+        size_t m_size = 0;
+};
+
+// Min cost flow on a paired edge list: edge i of addEdge is stored at 2i and
+// its reverse (no capacity, negated cost) at 2i+1, so the reverse of an edge
+// is idx ^ 1. Parallel edges and edges in both directions are fine, negative
+// costs too as long as there is no negative cycle.
+// An undirected edge takes a single pair as well, its two directions are each
+// other's reverse with the same capacity and cost. Its flow is signed, flow
+// against it first cancels at -cost, then it costs cost again, so the cost
+// must not be negative.
+// Primal-dual successive shortest paths: one SPFA from the source gives node
+// potentials, after that all reduced costs (cost + p[from] - p[to]) of
+// residual edges are non-negative and shortest paths are found by Dijkstra on
+// a radix heap. Dijkstra stops at the target, its distances (capped at the
+// target's one) are added to the potentials, which makes every edge on a
+// shortest path of zero reduced cost. All the shortest paths are then
+// augmented at once by a Dinitz blocking flow on the zero reduced cost edges,
+// each of them costs p[target] - p[source] per unit.
 class CostFlowNetwork {
-    public: 
+    public:
         CostFlowNetwork(size_t noNodes);
         void addEdge(int a, int b, long cap, long cost);
+        void addUndirectedEdge(int a, int b, long cap, long cost);
         long minCostFlow(int source, int target, long flowLimit);
+        size_t phases() const { return m_phases; }
 
         struct Edge {
             int from, to;
@@ -17,21 +90,44 @@ class CostFlowNetwork {
             : from(a), to(b), capacity(capacity), cost(cost) {
             }
 
+            // a direction of an undirected edge with flow the other way
+            // offers only that flow for cancelling
             long residue() const {
-                return capacity - flow;
+                return flow < 0 && capacity > 0 ? -flow : capacity - flow;
+            }
+
+            long unitCost() const {
+                return flow < 0 && capacity > 0 ? -cost : cost;
             }
         };
 
         inline static long INF = 1e18;
 
     private:
-        void augmentingPath(int source, int target, std::vector<int> & parents, std::vector<long> & costs) const;
+        void initPotentials(int source);
+        bool dijkstra(int source, int target);
+        bool levels(int source, int target);
+        long blockingFlow(int source, int target, long limit);
+
+        long reduced(const Edge & edge) const {
+            return edge.unitCost() + m_potential[edge.from] - m_potential[edge.to];
+        }
 
         std::vector<std::vector<int>> m_adjacent;
         std::vector<Edge> m_edges;
+
+        std::vector<long> m_potential;
+        std::vector<long> m_distance;
+        RadixHeap<int> m_heap;
+        // blocking flow on the zero reduced cost edges
+        std::vector<int> m_level;
+        std::vector<size_t> m_current;
+        std::vector<int> m_queue;
+        std::vector<int> m_path;
+        size_t m_phases = 0;
 };
 
-CostFlowNetwork::CostFlowNetwork(size_t noNodes) 
+CostFlowNetwork::CostFlowNetwork(size_t noNodes)
 : m_adjacent(noNodes){
 }
 
@@ -43,61 +139,56 @@ void CostFlowNetwork::addEdge(int a, int b, long cap, long cost) {
     m_adjacent[b].push_back(m);
 }
 
+void CostFlowNetwork::addUndirectedEdge(int a, int b, long cap, long cost) {
+    auto m = m_edges.size();
+    m_edges.emplace_back(Edge{a, b, cap, cost});
+    m_adjacent[a].push_back(m ++);
+    m_edges.emplace_back(Edge{b, a, cap, cost});
+    m_adjacent[b].push_back(m);
+}
+
+// Returns the cost of flowLimit units, -1 if that much does not fit.
 long CostFlowNetwork::minCostFlow(int source, int target, long flowLimit) {
+    size_t N = m_adjacent.size();
+    m_distance.resize(N);
+    m_level.resize(N);
+    m_current.resize(N);
+    m_queue.resize(N);
+
     long flow = 0;
     long cost = 0;
-
-    std::vector<int> parents;
-    std::vector<long> costs;
-    
-    while (flow < flowLimit) {
-        augmentingPath(source, target, parents, costs);
-        if (costs[target] == INF) break;
-
-        // find max flow
-        long path_flow = flowLimit - flow;
-        for (int current = target; current != source; ) {
-            Edge edge = m_edges[parents[current]];
-            path_flow = std::min(path_flow, edge.residue());
-            current = edge.from;
-        }
-
-        // apply flow
-        flow += path_flow;
-        cost += path_flow * costs[target];
-        // std::cerr << "augmenting path " << path_flow << ": ";
-        for (int current = target; current != source; ) {
-            int idx = parents[current];
-            m_edges[idx].flow += path_flow;
-            m_edges[idx ^ 1].flow -= path_flow;
-            // std::cerr << current << " -> " << m_edges[idx].from << " ";
-            current = m_edges[idx].from;
-        }
-        // std::cerr << "\n";
+    initPotentials(source);
+    while (flow < flowLimit && dijkstra(source, target)) {
+        ++ m_phases;
+        long pathCost = m_potential[target] - m_potential[source];
+        while (flow < flowLimit && levels(source, target)) {
+            long pathFlow = blockingFlow(source, target, flowLimit - flow);
+            flow += pathFlow;
+            cost += pathFlow * pathCost;
+        }
     }
 
-    // std::cerr << "flow " << flow << " cost " << cost << "\n";
     if (flow < flowLimit) return -1;
     return cost;
 }
 
-void CostFlowNetwork::augmentingPath(int source, int target, std::vector<int> & parents, std::vector<long> & costs) const{
+// Shortest distances from the source by SPFA, costs may be negative. Nodes the
+// source cannot reach never will, their potential does not matter.
+void CostFlowNetwork::initPotentials(int source) {
     size_t N = m_adjacent.size();
-    costs.assign(N, INF);
-    parents.assign(N, -1);
+    m_potential.assign(N, INF);
     std::vector<bool> inQ(N, false);
     std::deque<int> q = {source};
-    costs[source] = 0;
+    m_potential[source] = 0;
     while (!q.empty()) {
         auto current = q.front();
         q.pop_front();
         inQ[current] = false;
 
         for (int idx : m_adjacent[current]) {
-            auto edge = m_edges[idx];
-            if (edge.residue() > 0 && costs[edge.to] > costs[current] + edge.cost) {
-                costs[edge.to] = costs[current] + edge.cost;
-                parents[edge.to] = idx;
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_potential[edge.to] > m_potential[current] + edge.unitCost()) {
+                m_potential[edge.to] = m_potential[current] + edge.unitCost();
                 if (!inQ[edge.to]) {
                     inQ[edge.to] = true;
                     q.push_back(edge.to);
@@ -105,6 +196,111 @@ void CostFlowNetwork::augmentingPath(int source, int target, std::vector<int> &
             }
         }
     }
+    for (long & potential : m_potential) {
+        if (potential == INF) potential = 0;
+    }
+}
+
+// Dijkstra by reduced costs, then moves the potentials by the distances.
+bool CostFlowNetwork::dijkstra(int source, int target) {
+    std::fill(m_distance.begin(), m_distance.end(), INF);
+    m_heap.clear();
+    m_distance[source] = 0;
+    m_heap.push(0, source);
+    while (!m_heap.empty()) {
+        auto [distance, current] = m_heap.pop();
+        if ((long)distance != m_distance[current]) continue;
+        if (current == target) break;
+
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_distance[edge.to] > m_distance[current] + reduced(edge)) {
+                m_distance[edge.to] = m_distance[current] + reduced(edge);
+                m_heap.push(m_distance[edge.to], edge.to);
+            }
+        }
+    }
+    if (m_distance[target] == INF) return false;
+
+    // nodes not settled before the target keep their reduced costs non-negative
+    for (size_t v = 0; v < m_adjacent.size(); ++ v) {
+        m_potential[v] += std::min(m_distance[v], m_distance[target]);
+    }
+    return true;
+}
+
+// BFS levels over residual edges of zero reduced cost.
+bool CostFlowNetwork::levels(int source, int target) {
+    std::fill(m_level.begin(), m_level.end(), -1);
+    size_t head = 0, tail = 0;
+    m_queue[tail ++] = source;
+    m_level[source] = 0;
+    while (head < tail && m_level[target] == -1) {
+        int current = m_queue[head ++];
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_level[edge.to] == -1 && reduced(edge) == 0) {
+                m_level[edge.to] = m_level[current] + 1;
+                m_queue[tail ++] = edge.to;
+            }
+        }
+    }
+    return m_level[target] != -1;
+}
+
+// Iterative DFS as in Dinitz, edges on the path stack, dead ends leave the levels.
+long CostFlowNetwork::blockingFlow(int source, int target, long limit) {
+    std::fill(m_current.begin(), m_current.end(), 0);
+    m_path.clear();
+    long flow = 0;
+    int node = source;
+
+    while (flow < limit) {
+        if (node == target) {
+            long path_flow = limit - flow;
+            for (int idx : m_path) {
+                path_flow = std::min(path_flow, m_edges[idx].residue());
+            }
+            size_t saturated = m_path.size();
+            for (size_t i = 0; i < m_path.size(); ++ i) {
+                int idx = m_path[i];
+                m_edges[idx].flow += path_flow;
+                m_edges[idx ^ 1].flow -= path_flow;
+                // cancelling all the flow of an undirected edge turns it around
+                // at a positive reduced cost, then it is no longer on the level graph
+                bool blocked = m_edges[idx].residue() == 0 || reduced(m_edges[idx]) != 0;
+                if (blocked && saturated == m_path.size()) saturated = i;
+            }
+            flow += path_flow;
+            // continue from the tail of the first saturated edge
+            m_path.resize(saturated);
+            node = m_path.empty() ? source : m_edges[m_path.back()].to;
+            continue;
+        }
+
+        // advance
+        const std::vector<int> & adjacent = m_adjacent[node];
+        size_t & i = m_current[node];
+        while (i < adjacent.size()) {
+            const Edge & edge = m_edges[adjacent[i]];
+            if (edge.residue() > 0 && m_level[edge.to] == m_level[node] + 1 && reduced(edge) == 0) break;
+            ++ i;
+        }
+        if (i < adjacent.size()) {
+            m_path.push_back(adjacent[i]);
+            node = m_edges[adjacent[i]].to;
+            continue;
+        }
+
+        // retreat
+        if (node == source) break;
+        m_level[node] = -1;
+        m_path.pop_back();
+        node = m_path.empty() ? source : m_edges[m_path.back()].to;
+        ++ m_current[node];
+    }
+
+    return flow;
 }
 
 // https://www.spoj.com/problems/GREED/
@@ -142,9 +338,7 @@ bool GREED_Greedy_island () {
         if (!(std::cin >> from >> to)) {
             return false;
         }
-        network.addEdge(from, to, CostFlowNetwork::INF, 1);
-        // unfortunately
-        network.addEdge(to, from, CostFlowNetwork::INF, 1);
+        network.addUndirectedEdge(from, to, CostFlowNetwork::INF, 1);
     }
 
     auto flow = network.minCostFlow(source, target, N);
@@ -1,115 +1,295 @@
 #include <vector>
 #include <deque>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <iostream>
-#include <set>
-
-// This implementation is modified Edmonds-Karp for computin max flow.
-// Edges of negative costs are allowed.
-// Algorithm to find the shortest path (in terms of costs) is called Shortest Path Faster Algorithm (SPFA), because of negative costs. 
-// No parallel edges, each pair of node can only have edge in one direction or none.
-class NetworkCostFlow {
-    public: 
-        NetworkCostFlow(size_t noNodes);
+
+// Monotone priority queue for Dijkstra with non-negative integer keys: no key
+// pushed may be smaller than the last one popped. Bucket i holds keys which
+// first differ from the last popped key in bit i - 1, when bucket 0 runs
+// empty the smallest nonempty bucket is redistributed into lower ones. Every
+// element moves down at most 64 times, O(log C) amortized per operation.
+template <class Value>
+class RadixHeap {
+    public:
+        void push(uint64_t key, Value value) {
+            m_buckets[bucket(key)].emplace_back(key, value);
+            ++ m_size;
+        }
+
+        // smallest key and its value
+        std::pair<uint64_t, Value> pop() {
+            if (m_buckets[0].empty()) refill();
+            auto top = m_buckets[0].back();
+            m_buckets[0].pop_back();
+            -- m_size;
+            return top;
+        }
+
+        bool empty() const { return m_size == 0; }
+
+        void clear() {
+            for (auto & bucket : m_buckets) bucket.clear();
+            m_last = 0;
+            m_size = 0;
+        }
+
+    private:
+        size_t bucket(uint64_t key) const {
+            return key == m_last ? 0 : 64 - std::countl_zero(key ^ m_last);
+        }
+
+        void refill() {
+            size_t i = 1;
+            while (m_buckets[i].empty()) ++ i;
+            uint64_t minimum = m_buckets[i][0].first;
+            for (const auto & [key, value] : m_buckets[i]) minimum = std::min(minimum, key);
+            m_last = minimum;
+            for (const auto & [key, value] : m_buckets[i]) {
+                m_buckets[bucket(key)].emplace_back(key, value);
+            }
+            m_buckets[i].clear();
+        }
+
+        std::array<std::vector<std::pair<uint64_t, Value>>, 65> m_buckets;
+        uint64_t m_last = 0;
+        size_t m_size = 0;
+};
+
+// Min cost flow on a paired edge list: edge i of addEdge is stored at 2i and
+// its reverse (no capacity, negated cost) at 2i+1, so the reverse of an edge
+// is idx ^ 1 and memory grows with the number of edges only. Parallel edges
+// and edges in both directions are fine, negative costs too as long as there
+// is no negative cycle.
+// Primal-dual successive shortest paths: one SPFA from the source gives node
+// potentials, after that all reduced costs (cost + p[from] - p[to]) of
+// residual edges are non-negative and shortest paths are found by Dijkstra on
+// a radix heap. Dijkstra stops at the target, its distances (capped at the
+// target's one) are added to the potentials, which makes every edge on a
+// shortest path of zero reduced cost. All the shortest paths are then
+// augmented at once by a Dinitz blocking flow on the zero reduced cost edges,
+// each of them costs p[target] - p[source] per unit.
+class CostFlowNetwork {
+    public:
+        CostFlowNetwork(size_t noNodes);
         void addEdge(int a, int b, long cap, long cost);
         long minCostFlow(int source, int target, long flowLimit);
+        size_t phases() const { return m_phases; }
+        std::vector<long> flows() const;
+
+        struct Edge {
+            int from, to;
+            long capacity, flow = 0, cost;
+            Edge (int a, int b, long capacity, long cost)
+            : from(a), to(b), capacity(capacity), cost(cost) {
+            }
+
+            long residue() const {
+                return capacity - flow;
+            }
+        };
 
-        static long INF;
-        // for task
-        auto getResidueNetwork() const { return m_residues; }
+        inline static long INF = 1e18;
 
     private:
-        void augmentingPath(int source, int target, std::vector<int> & parents, std::vector<long> & costs) const;
+        void initPotentials(int source);
+        bool dijkstra(int source, int target);
+        bool levels(int source, int target);
+        long blockingFlow(int source, int target, long limit);
+
+        long reduced(const Edge & edge) const {
+            return edge.cost + m_potential[edge.from] - m_potential[edge.to];
+        }
 
         std::vector<std::vector<int>> m_adjacent;
-        std::vector<std::vector<long>> m_residues;
-        std::vector<std::vector<long>> m_cost;
-        std::set<std::pair<int, int>> m_existingEdges;
-};
+        std::vector<Edge> m_edges;
 
-long NetworkCostFlow::INF = 1e18;
+        std::vector<long> m_potential;
+        std::vector<long> m_distance;
+        RadixHeap<int> m_heap;
+        // blocking flow on the zero reduced cost edges
+        std::vector<int> m_level;
+        std::vector<size_t> m_current;
+        std::vector<int> m_queue;
+        std::vector<int> m_path;
+        size_t m_phases = 0;
+};
 
-NetworkCostFlow::NetworkCostFlow(size_t noNodes) 
-: m_adjacent(noNodes)
-, m_residues(noNodes, std::vector<long>(noNodes, 0))
-, m_cost(noNodes, std::vector<long>(noNodes, 0)) {
+CostFlowNetwork::CostFlowNetwork(size_t noNodes)
+: m_adjacent(noNodes){
 }
 
-void NetworkCostFlow::addEdge(int a, int b, long cap, long cost) {
-    if (m_existingEdges.count({a,b}) == 0 && m_existingEdges.count({b,a}) == 0) {
-        m_adjacent[a].push_back(b);
-        m_adjacent[b].push_back(a);
-        m_residues[a][b] = cap;
-        m_cost[a][b] = cost;
-        m_cost[b][a] = -cost;
-        m_existingEdges.insert({a,b});
-    } else {
-        throw std::invalid_argument("either parallel edge or counter edge to some other.");
-    }
+void CostFlowNetwork::addEdge(int a, int b, long cap, long cost) {
+    auto m = m_edges.size();
+    m_edges.emplace_back(Edge{a, b, cap, cost});
+    m_adjacent[a].push_back(m ++);
+    m_edges.emplace_back(Edge{b, a, 0, -cost});
+    m_adjacent[b].push_back(m);
 }
 
-long NetworkCostFlow::minCostFlow(int source, int target, long flowLimit) {
+// Returns the cost of flowLimit units, -1 if that much does not fit.
+long CostFlowNetwork::minCostFlow(int source, int target, long flowLimit) {
+    size_t N = m_adjacent.size();
+    m_distance.resize(N);
+    m_level.resize(N);
+    m_current.resize(N);
+    m_queue.resize(N);
+
     long flow = 0;
     long cost = 0;
-
-    std::vector<int> parents;
-    std::vector<long> costs;
-    
-    while (flow < flowLimit) {
-        augmentingPath(source, target, parents, costs);
-        if (costs[target] == INF) break;
-
-        // find max flow
-        long path_flow = flowLimit - flow;
-        for (int current = target; current != source; ) {
-            int prev = parents[current];
-            path_flow = std::min(path_flow, m_residues[prev][current]);
-            current = prev;
-        }
- 
-        // apply flow
-        flow += path_flow;
-        cost += path_flow * costs[target];
-        // std::cout << "augmenting path " << path_flow << ": ";
-        for (int current = target; current != source; ) {
-            int prev = parents[current];
-            m_residues[prev][current] -= path_flow;
-            m_residues[current][prev] += path_flow;
-            // std::cout << current << " -> " << prev << " ";
-            current = prev;
+    initPotentials(source);
+    while (flow < flowLimit && dijkstra(source, target)) {
+        ++ m_phases;
+        long pathCost = m_potential[target] - m_potential[source];
+        while (flow < flowLimit && levels(source, target)) {
+            long pathFlow = blockingFlow(source, target, flowLimit - flow);
+            flow += pathFlow;
+            cost += pathFlow * pathCost;
         }
-        // std::cout << "\n";
     }
 
     if (flow < flowLimit) return -1;
-
     return cost;
 }
 
-void NetworkCostFlow::augmentingPath(int source, int target, std::vector<int> & parents, std::vector<long> & costs) const{
+// Shortest distances from the source by SPFA, costs may be negative. Nodes the
+// source cannot reach never will, their potential does not matter.
+void CostFlowNetwork::initPotentials(int source) {
     size_t N = m_adjacent.size();
-    costs.assign(N, INF);
-    parents.assign(N, -1);
+    m_potential.assign(N, INF);
     std::vector<bool> inQ(N, false);
     std::deque<int> q = {source};
-    costs[source] = 0;
+    m_potential[source] = 0;
     while (!q.empty()) {
         auto current = q.front();
         q.pop_front();
         inQ[current] = false;
 
-        for (int next : m_adjacent[current]) {
-            if (m_residues[current][next] > 0 && costs[next] > costs[current] + m_cost[current][next]) {
-                costs[next] = costs[current] + m_cost[current][next];
-                parents[next] = current;
-                if (!inQ[next]) {
-                    inQ[next] = true;
-                    q.push_back(next);
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_potential[edge.to] > m_potential[current] + edge.cost) {
+                m_potential[edge.to] = m_potential[current] + edge.cost;
+                if (!inQ[edge.to]) {
+                    inQ[edge.to] = true;
+                    q.push_back(edge.to);
                 }
             }
         }
     }
+    for (long & potential : m_potential) {
+        if (potential == INF) potential = 0;
+    }
+}
+
+// Dijkstra by reduced costs, then moves the potentials by the distances.
+bool CostFlowNetwork::dijkstra(int source, int target) {
+    std::fill(m_distance.begin(), m_distance.end(), INF);
+    m_heap.clear();
+    m_distance[source] = 0;
+    m_heap.push(0, source);
+    while (!m_heap.empty()) {
+        auto [distance, current] = m_heap.pop();
+        if ((long)distance != m_distance[current]) continue;
+        if (current == target) break;
+
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_distance[edge.to] > m_distance[current] + reduced(edge)) {
+                m_distance[edge.to] = m_distance[current] + reduced(edge);
+                m_heap.push(m_distance[edge.to], edge.to);
+            }
+        }
+    }
+    if (m_distance[target] == INF) return false;
+
+    // nodes not settled before the target keep their reduced costs non-negative
+    for (size_t v = 0; v < m_adjacent.size(); ++ v) {
+        m_potential[v] += std::min(m_distance[v], m_distance[target]);
+    }
+    return true;
+}
+
+// BFS levels over residual edges of zero reduced cost.
+bool CostFlowNetwork::levels(int source, int target) {
+    std::fill(m_level.begin(), m_level.end(), -1);
+    size_t head = 0, tail = 0;
+    m_queue[tail ++] = source;
+    m_level[source] = 0;
+    while (head < tail && m_level[target] == -1) {
+        int current = m_queue[head ++];
+        for (int idx : m_adjacent[current]) {
+            const Edge & edge = m_edges[idx];
+            if (edge.residue() > 0 && m_level[edge.to] == -1 && reduced(edge) == 0) {
+                m_level[edge.to] = m_level[current] + 1;
+                m_queue[tail ++] = edge.to;
+            }
+        }
+    }
+    return m_level[target] != -1;
 }
 
+// Iterative DFS as in Dinitz, edges on the path stack, dead ends leave the levels.
+long CostFlowNetwork::blockingFlow(int source, int target, long limit) {
+    std::fill(m_current.begin(), m_current.end(), 0);
+    m_path.clear();
+    long flow = 0;
+    int node = source;
+
+    while (flow < limit) {
+        if (node == target) {
+            long path_flow = limit - flow;
+            for (int idx : m_path) {
+                path_flow = std::min(path_flow, m_edges[idx].residue());
+            }
+            size_t saturated = m_path.size();
+            for (size_t i = 0; i < m_path.size(); ++ i) {
+                int idx = m_path[i];
+                m_edges[idx].flow += path_flow;
+                m_edges[idx ^ 1].flow -= path_flow;
+                if (m_edges[idx].residue() == 0 && saturated == m_path.size()) saturated = i;
+            }
+            flow += path_flow;
+            // continue from the tail of the first saturated edge
+            m_path.resize(saturated);
+            node = m_path.empty() ? source : m_edges[m_path.back()].to;
+            continue;
+        }
+
+        // advance
+        const std::vector<int> & adjacent = m_adjacent[node];
+        size_t & i = m_current[node];
+        while (i < adjacent.size()) {
+            const Edge & edge = m_edges[adjacent[i]];
+            if (edge.residue() > 0 && m_level[edge.to] == m_level[node] + 1 && reduced(edge) == 0) break;
+            ++ i;
+        }
+        if (i < adjacent.size()) {
+            m_path.push_back(adjacent[i]);
+            node = m_edges[adjacent[i]].to;
+            continue;
+        }
+
+        // retreat
+        if (node == source) break;
+        m_level[node] = -1;
+        m_path.pop_back();
+        node = m_path.empty() ? source : m_edges[m_path.back()].to;
+        ++ m_current[node];
+    }
+
+    return flow;
+}
+
+// Flow of every edge in addEdge order.
+std::vector<long> CostFlowNetwork::flows() const {
+    std::vector<long> flows(m_edges.size() / 2);
+    for (size_t i = 0; i < flows.size(); ++ i) {
+        flows[i] = m_edges[2 * i].flow;
+    }
+    return flows;
+}
 
 // Tested
 // CSES Task Assignment https://cses.fi/problemset/task/2129
@@ -123,7 +303,7 @@ bool Task_Assignment() {
     const int source = 0;
     const int target = 2*N+1;
 
-    NetworkCostFlow network(2*N+2);
+    CostFlowNetwork network(2*N+2);
 
     for (int i = 1; i <= N; i ++) {
         int employe = i;
@@ -144,11 +324,13 @@ bool Task_Assignment() {
     // Looking for the cost of flow N from source to target.
     auto cost = network.minCostFlow(source, target, N);
     std::cout << cost << "\n";
-    // Show employee and task assignments
-    auto residue = network.getResidueNetwork();
+    // Show employee and task assignments, the employee to task edges follow
+    // the 2N edges of the source and the target
+    auto flows = network.flows();
     for (int employee = 1; employee <= N; employee ++) {
         for (int task = N+1; task <= N+N; task ++) {
-            if (residue[employee][task] == 0) {
+            int edge = 2*N + (employee-1)*N + (task-N-1);
+            if (flows[edge] == 1) {
                 std::cout << employee << " " << task-N << "\n";
             }
         }
@@ -0,0 +1,242 @@
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+#include <bit>
+#include <cmath>
+
+// Maximum bipartite matching by Hopcroft-Karp, for unit capacity networks
+// where a general max flow network would spend two edge records per pair.
+// Adjacency is a dense bitset, row per left node of (right + 63) / 64 words,
+// so a dense people x cars graph of 20k x 20k takes 50 MB instead of gigabytes
+// of edges. Both the BFS and the DFS scan a row word by word masked with the
+// right nodes still unvisited in the phase, every right node is taken at most
+// once per phase: O(sqrt(V) (V * right / 64 + E)).
+class HopcroftKarp {
+    public:
+        HopcroftKarp(size_t left, size_t right);
+        void addEdge(int a, int b);
+        int maxMatching();
+
+        // matched right node of a left one and vice versa, -1 if free
+        int matchOfLeft(int a) const { return m_matchLeft[a]; }
+        int matchOfRight(int b) const { return m_matchRight[b]; }
+        size_t phases() const { return m_phases; }
+
+    private:
+        bool bfs();
+        bool augmentFrom(int root);
+
+        // a pointer, not an element: without right nodes the rows have no words
+        const uint64_t * row(int a) const { return m_adjacent.data() + a * m_words; }
+        bool alive(int b) const { return m_alive[b / 64] >> (b % 64) & 1; }
+        void kill(int b) { m_alive[b / 64] &= ~(uint64_t(1) << (b % 64)); }
+
+        size_t m_left, m_right, m_words;
+        std::vector<uint64_t> m_adjacent;
+        std::vector<int> m_matchLeft;
+        std::vector<int> m_matchRight;
+
+        // phase buffers
+        std::vector<int> m_distance; // BFS layer of left nodes, -1 if not reached
+        std::vector<uint64_t> m_alive; // right nodes not visited yet in this phase
+        std::vector<int> m_queue;
+        std::vector<int> m_stack;
+        std::vector<int> m_word; // word of the row the DFS is at, per left node
+        std::vector<uint64_t> m_bits; // bits of that word not tried yet
+        std::vector<int> m_via; // right node the DFS went through
+        size_t m_phases = 0;
+};
+
+inline HopcroftKarp::HopcroftKarp(size_t left, size_t right)
+: m_left(left)
+, m_right(right)
+, m_words((right + 63) / 64)
+, m_adjacent(left * m_words, 0)
+, m_matchLeft(left, -1)
+, m_matchRight(right, -1)
+, m_distance(left)
+, m_alive(m_words)
+, m_queue(left)
+, m_word(left)
+, m_bits(left)
+, m_via(left)
+{
+    m_stack.reserve(left);
+}
+
+inline void HopcroftKarp::addEdge(int a, int b) {
+    m_adjacent[a * m_words + b / 64] |= uint64_t(1) << (b % 64);
+}
+
+// Layers of left nodes by alternating paths from the free ones, stops at the
+// first layer which sees a free right node.
+inline bool HopcroftKarp::bfs() {
+    std::fill(m_distance.begin(), m_distance.end(), -1);
+    std::fill(m_alive.begin(), m_alive.end(), ~uint64_t(0));
+    size_t head = 0, tail = 0;
+    for (size_t a = 0; a < m_left; ++ a) {
+        if (m_matchLeft[a] == -1) {
+            m_distance[a] = 0;
+            m_queue[tail ++] = a;
+        }
+    }
+
+    int limit = -1;
+    while (head < tail) {
+        int current = m_queue[head ++];
+        if (limit != -1 && m_distance[current] >= limit) break;
+
+        const uint64_t * adjacent = row(current);
+        for (size_t w = 0; w < m_words; ++ w) {
+            for (uint64_t bits = adjacent[w] & m_alive[w]; bits; bits &= bits - 1) {
+                int b = w * 64 + std::countr_zero(bits);
+                kill(b);
+                int next = m_matchRight[b];
+                if (next == -1) {
+                    limit = m_distance[current] + 1;
+                } else if (m_distance[next] == -1) {
+                    m_distance[next] = m_distance[current] + 1;
+                    m_queue[tail ++] = next;
+                }
+            }
+        }
+    }
+    // paths longer than the shortest one wait for the next phase
+    for (size_t i = 0; i < tail; ++ i) {
+        if (m_distance[m_queue[i]] >= limit) m_distance[m_queue[i]] = -1;
+    }
+    return limit != -1;
+}
+
+// Iterative DFS along the layers, dead ends are dropped from the layers.
+inline bool HopcroftKarp::augmentFrom(int root) {
+    auto load = [&](int a) {
+        m_word[a] = 0;
+        m_bits[a] = m_words ? row(a)[0] & m_alive[0] : 0;
+    };
+    m_stack.clear();
+    m_stack.push_back(root);
+    load(root);
+
+    while (!m_stack.empty()) {
+        int current = m_stack.back();
+        uint64_t & bits = m_bits[current];
+        while (bits == 0 && ++ m_word[current] < (int)m_words) {
+            bits = row(current)[m_word[current]] & m_alive[m_word[current]];
+        }
+        if (bits == 0) {
+            m_distance[current] = -1;
+            m_stack.pop_back();
+            continue;
+        }
+
+        int b = m_word[current] * 64 + std::countr_zero(bits);
+        bits &= bits - 1;
+        if (!alive(b)) continue;
+        int next = m_matchRight[b];
+        if (next != -1 && m_distance[next] != m_distance[current] + 1) continue;
+
+        kill(b);
+        m_via[current] = b;
+        if (next == -1) {
+            for (int a : m_stack) {
+                m_matchLeft[a] = m_via[a];
+                m_matchRight[m_via[a]] = a;
+            }
+            return true;
+        }
+        m_stack.push_back(next);
+        load(next);
+    }
+    return false;
+}
+
+// Returns the size of the maximum matching, continues from the current matching.
+inline int HopcroftKarp::maxMatching() {
+    while (bfs()) {
+        ++ m_phases;
+        std::fill(m_alive.begin(), m_alive.end(), ~uint64_t(0));
+        for (size_t a = 0; a < m_left; ++ a) {
+            if (m_matchLeft[a] == -1) augmentFrom(a);
+        }
+    }
+
+    int matched = 0;
+    for (int b : m_matchLeft) matched += b != -1;
+    return matched;
+}
+
+struct Coord {
+    int x;
+    int y;
+};
+
+// Calls emit(i, j) for every point i of `from` and point j of `to` within
+// Manhattan distance reach, without trying all the pairs. Rotating by 45
+// degrees (u = x + y, v = x - y) turns the Manhattan ball into the Chebyshev
+// square max(|du|, |dv|) <= reach, so points of `to` are bucketed into square
+// cells of side reach + 1 and only the 3 x 3 cells around a point of `from`
+// are checked. Cells are sorted by (u cell, v cell), each row of three cells
+// is one binary search and a contiguous scan: O((|from| + |to|) log |to| +
+// candidates), candidates being within a constant factor of the output for
+// evenly spread points. Point needs integer members x and y.
+template <class Point, class Emit>
+void manhattanPairs(const std::vector<Point> & from, const std::vector<Point> & to, long reach, Emit emit) {
+    if (reach < 0) return;
+    const long side = reach + 1;
+    // floor division, rotated coordinates may be negative
+    auto cell = [side](long c) { return c >= 0 ? c / side : -((-c + side - 1) / side); };
+    auto key = [&](const Point & p) {
+        return std::pair<long, long>(cell((long)p.x + p.y), cell((long)p.x - p.y));
+    };
+
+    std::vector<std::pair<std::pair<long, long>, int>> cells(to.size());
+    for (size_t j = 0; j < to.size(); ++ j) {
+        cells[j] = {key(to[j]), (int)j};
+    }
+    std::sort(cells.begin(), cells.end());
+
+    for (size_t i = 0; i < from.size(); ++ i) {
+        const Point & p = from[i];
+        auto [cu, cv] = key(p);
+        for (long u = cu - 1; u <= cu + 1; ++ u) {
+            auto it = std::lower_bound(cells.begin(), cells.end(), std::pair(std::pair(u, cv - 1), -1));
+            for (; it != cells.end() && it->first.first == u && it->first.second <= cv + 1; ++ it) {
+                const Point & q = to[it->second];
+                if (std::abs((long)p.x - q.x) + std::abs((long)p.y - q.y) <= reach) {
+                    emit((int)i, it->second);
+                }
+            }
+        }
+    }
+}
+
+void taxi() {
+    int peopleCnt, carsCnt;
+    long speed, time;
+    std::cin >> peopleCnt >> carsCnt >> speed >> time;
+    std::vector<Coord> people(peopleCnt), cars(carsCnt);
+    for (auto & p : people) std::cin >> p.x >> p.y;
+    for (auto & c : cars) std::cin >> c.x >> c.y;
+
+    HopcroftKarp matching(peopleCnt, carsCnt);
+    // distance * 200 <= speed * time
+    manhattanPairs(people, cars, speed * time / 200, [&](int i, int j) {
+        matching.addEdge(i, j);
+    });
+
+    std::cout << matching.maxMatching() << "\n";
+}
+
+int main()
+{
+    int testCases;
+    std::cin >> testCases;
+
+    while (testCases --) {
+        taxi();
+    }
+ 
+    return 0;
+}
\ No newline at end of file